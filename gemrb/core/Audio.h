@@ -124,6 +124,8 @@ public:
 	virtual void QueueBuffer(int stream, unsigned short bits,
 				int channels, short* memory, int size, int samplerate) = 0;
 	virtual void UpdateMapAmbient(MapReverb&) {};
+	// hint that these sounds will be played soon, so they can be decoded ahead of time
+	virtual void Prefetch(const std::vector<ResRef>&) {};
 
 	unsigned int CreateChannel(const char *name);
 	void SetChannelVolume(const char *name, int volume);
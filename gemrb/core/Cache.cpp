@@ -79,7 +79,10 @@ void Cache::RemoveAll(ReleaseFun fun)
 	}
 
 	m_nCount = 0;
+	m_nBytes = 0;
 	m_pFreeList = NULL;
+	m_pIdleHead = nullptr;
+	m_pIdleTail = nullptr;
 
 	// free memory blocks
 	MemBlock* p = m_pBlocks;
@@ -125,11 +128,17 @@ Cache::MyAssoc* Cache::NewAssoc()
 	pAssoc->data = 0;
 #endif
 	pAssoc->nRefCount=1;
+	pAssoc->size = 0;
+	pAssoc->idle = false;
+	pAssoc->idleNext = nullptr;
+	pAssoc->idlePrev = nullptr;
 	return pAssoc;
 }
 
 void Cache::FreeAssoc(Cache::MyAssoc* pAssoc)
 {
+	UnlinkIdle(pAssoc);
+	m_nBytes -= pAssoc->size;
 	if(pAssoc->pNext) {
 		pAssoc->pNext->pPrev=pAssoc->pPrev;
 	}
@@ -192,19 +201,22 @@ Cache::MyAssoc* Cache::GetAssocAt(const ResRef& key) const
 	return NULL;
 }
 
-void *Cache::GetResource(const ResRef& key) const
+void *Cache::GetResource(const ResRef& key)
 {
 	Cache::MyAssoc* pAssoc = GetAssocAt( key );
 	if (pAssoc == NULL) {
+		m_stats.misses++;
 		return NULL;
 	} // not in map
 
+	m_stats.hits++;
+	UnlinkIdle(pAssoc);
 	pAssoc->nRefCount++;
 	return pAssoc->data;
 }
 
 //returns true if it was successful
-bool Cache::SetAt(const ResRef& key, void *rValue)
+bool Cache::SetAt(const ResRef& key, void *rValue, size_t size)
 {
 	if (key.IsEmpty()) return false;
 
@@ -223,6 +235,8 @@ bool Cache::SetAt(const ResRef& key, void *rValue)
 	pAssoc = NewAssoc();
 	pAssoc->key = key;
 	pAssoc->data=rValue;
+	pAssoc->size = size;
+	m_nBytes += size;
 	// put into hash table
 	size_t nHash = MyHashKey(pAssoc->key) % m_nHashTableSize;
 	pAssoc->pNext = m_pHashTable[nHash];
@@ -258,6 +272,9 @@ int Cache::DecRef(const void *data, const ResRef& key, bool remove)
 				FreeAssoc(pAssoc);
 				return 0;
 			}
+			if (!pAssoc->nRefCount) {
+				LinkIdle(pAssoc);
+			}
 			return pAssoc->nRefCount;
 		}
 		return -1;
@@ -275,6 +292,9 @@ int Cache::DecRef(const void *data, const ResRef& key, bool remove)
 				FreeAssoc(pAssoc);
 				return 0;
 			}
+			if (!pAssoc->nRefCount) {
+				LinkIdle(pAssoc);
+			}
 			return pAssoc->nRefCount;
 		}
 		pAssoc=GetNextAssoc(pAssoc);
@@ -296,4 +316,56 @@ void Cache::Cleanup()
 	}
 }
 
+void Cache::SetBudget(size_t bytes, ReleaseFun fun)
+{
+	m_nBudget = bytes;
+	m_release = fun;
+	Trim();
+}
+
+void Cache::LinkIdle(Cache::MyAssoc* pAssoc)
+{
+	pAssoc->idle = true;
+	pAssoc->idleNext = nullptr;
+	pAssoc->idlePrev = m_pIdleTail;
+	if (m_pIdleTail) {
+		m_pIdleTail->idleNext = pAssoc;
+	} else {
+		m_pIdleHead = pAssoc;
+	}
+	m_pIdleTail = pAssoc;
+}
+
+void Cache::UnlinkIdle(Cache::MyAssoc* pAssoc)
+{
+	if (!pAssoc->idle) return;
+
+	if (pAssoc->idlePrev) {
+		pAssoc->idlePrev->idleNext = pAssoc->idleNext;
+	} else {
+		m_pIdleHead = pAssoc->idleNext;
+	}
+	if (pAssoc->idleNext) {
+		pAssoc->idleNext->idlePrev = pAssoc->idlePrev;
+	} else {
+		m_pIdleTail = pAssoc->idlePrev;
+	}
+	pAssoc->idle = false;
+	pAssoc->idleNext = nullptr;
+	pAssoc->idlePrev = nullptr;
+}
+
+void Cache::Trim()
+{
+	if (!m_nBudget || !m_release) return;
+
+	while (m_nBytes > m_nBudget && m_pIdleHead) {
+		Cache::MyAssoc* pAssoc = m_pIdleHead;
+		void* data = pAssoc->data;
+		FreeAssoc(pAssoc);
+		m_release(data);
+		m_stats.evictions++;
+	}
+}
+
 }
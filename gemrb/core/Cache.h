@@ -39,12 +39,23 @@ protected:
 		ResRef key;
 		ieDword nRefCount;
 		void* data;
+		size_t size;
+		// unreferenced entries, from the least to the most recently released
+		bool idle;
+		MyAssoc* idleNext;
+		MyAssoc* idlePrev;
 	};
 	struct MemBlock {
 		MemBlock* pNext;
 	};
 
 public:
+	struct Stats {
+		unsigned long hits = 0;
+		unsigned long misses = 0;
+		unsigned long evictions = 0;
+	};
+
 	// Construction
 	explicit Cache(int nBlockSize = 10, int nHashTableSize = 129);
 	Cache(const Cache&) = delete;
@@ -61,10 +72,19 @@ public:
 	{
 		return m_nCount==0;
 	}
+	inline size_t GetSize() const
+	{
+		return m_nBytes;
+	}
+	inline const Stats& GetStats() const
+	{
+		return m_stats;
+	}
 	// Lookup
-	void *GetResource(const ResRef& key) const;
+	void *GetResource(const ResRef& key);
 	// Operations
-	bool SetAt(const ResRef& key, void *rValue);
+	// size is the approximate memory taken by the data, it is only used for the budget
+	bool SetAt(const ResRef& key, void *rValue, size_t size = 0);
 	// decreases refcount or drops data
 	//if name is supplied it is faster, it will use rValue to validate the request
 	int DecRef(const void *rValue, const ResRef& name, bool free);
@@ -72,6 +92,13 @@ public:
 	void RemoveAll(ReleaseFun fun);//removes all refcounts
 	void Cleanup();  //removes only zero refcounts
 	void InitHashTable(unsigned int hashSize, bool bAllocNow = true);
+	// unreferenced entries are kept until all the entries take more than
+	// bytes, then Trim drops the least recently used ones with fun
+	// 0 keeps them all, which is the default
+	void SetBudget(size_t bytes, ReleaseFun fun);
+	// callers keep using data for a while after releasing it (eg. item headers
+	// during an attack), so this must only run when nothing is in flight
+	void Trim();
 
 	// Implementation
 protected:
@@ -81,11 +108,19 @@ protected:
 	MyAssoc* m_pFreeList = nullptr;
 	MemBlock* m_pBlocks = nullptr;
 	int m_nBlockSize;
+	size_t m_nBytes = 0;
+	size_t m_nBudget = 0;
+	ReleaseFun m_release = nullptr;
+	MyAssoc* m_pIdleHead = nullptr;
+	MyAssoc* m_pIdleTail = nullptr;
+	Stats m_stats;
 
 	Cache::MyAssoc* NewAssoc();
 	void FreeAssoc(Cache::MyAssoc*);
 	Cache::MyAssoc* GetAssocAt(const ResRef&) const;
 	Cache::MyAssoc *GetNextAssoc(Cache::MyAssoc * rNextPosition) const;
+	void LinkIdle(Cache::MyAssoc*);
+	void UnlinkIdle(Cache::MyAssoc*);
 };
 
 }
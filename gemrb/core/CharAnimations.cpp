@@ -488,6 +488,19 @@ void CharAnimations::CheckColorMod()
 	lockPalette = false;
 }
 
+bool CharAnimations::HasColorMod() const
+{
+	if (GlobalColorMod.type != RGBModifier::NONE) {
+		return true;
+	}
+	for (const auto& mod : ColorMods) {
+		if (mod.type != RGBModifier::NONE) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void CharAnimations::SetupColors(PaletteType type)
 {
 	PaletteHolder pal = PartPalettes[type];
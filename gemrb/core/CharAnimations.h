@@ -200,6 +200,8 @@ public:
 	void SetOffhandRef(const char* ref);
 	void SetColors(const ieDword *Colors);
 	void CheckColorMod();
+	// true while a color modification is set, CheckColorMod may need to clear it
+	bool HasColorMod() const;
 	void SetupColors(PaletteType type);
 	void LockPalette(const ieDword *Colors);
 
@@ -36,6 +36,7 @@
 #include "Spell.h" //needs for the source flags bitfield
 #include "TableMgr.h"
 
+#include <algorithm>
 #include <cstdio>
 #include "GameData.h"
 
@@ -421,12 +422,96 @@ Effect *EffectQueue::CreateUnsummonEffect(const Effect *fx)
 	return newfx;
 }
 
+EffectQueue::EffectQueue(const EffectQueue& other)
+: effects(other.effects), Owner(other.Owner)
+{
+	RebuildIndex();
+}
+
+EffectQueue& EffectQueue::operator=(const EffectQueue& other)
+{
+	if (this != &other) {
+		effects = other.effects;
+		Owner = other.Owner;
+		RebuildIndex();
+	}
+	return *this;
+}
+
+EffectQueue::OpcodeView<Effect> EffectQueue::EffectsOf(ieDword opcode)
+{
+	static const bucket_t none;
+	if (opcode >= opcodeIndex.size()) return OpcodeView<Effect>(none);
+	return OpcodeView<Effect>(opcodeIndex[opcode]);
+}
+
+EffectQueue::OpcodeView<const Effect> EffectQueue::EffectsOf(ieDword opcode) const
+{
+	static const bucket_t none;
+	if (opcode >= opcodeIndex.size()) return OpcodeView<const Effect>(none);
+	return OpcodeView<const Effect>(opcodeIndex[opcode]);
+}
+
+void EffectQueue::IndexEffect(Effect* fx, bool insert)
+{
+	// bogus opcodes are never looked up, they just expire when applied
+	if (fx->Opcode >= Globals::MAX_EFFECTS) return;
+
+	if (fx->Opcode >= opcodeIndex.size()) {
+		opcodeIndex.resize(fx->Opcode + 1);
+	}
+	bucket_t& bucket = opcodeIndex[fx->Opcode];
+	if (insert) {
+		bucket.insert(bucket.begin(), fx);
+	} else {
+		bucket.push_back(fx);
+	}
+}
+
+void EffectQueue::UnindexEffect(const Effect* fx)
+{
+	if (fx->Opcode >= opcodeIndex.size()) return;
+
+	bucket_t& bucket = opcodeIndex[fx->Opcode];
+	auto it = std::find(bucket.begin(), bucket.end(), fx);
+	if (it != bucket.end()) {
+		bucket.erase(it);
+	}
+}
+
+//rebuilds a single bucket, needed when an effect changed its opcode in place
+void EffectQueue::ReindexOpcode(ieDword opcode)
+{
+	if (opcode >= Globals::MAX_EFFECTS) return;
+
+	if (opcode >= opcodeIndex.size()) {
+		opcodeIndex.resize(opcode + 1);
+	}
+	bucket_t& bucket = opcodeIndex[opcode];
+	bucket.clear();
+	for (auto& fx : effects) {
+		if (fx.Opcode == opcode) {
+			bucket.push_back(&fx);
+		}
+	}
+}
+
+void EffectQueue::RebuildIndex()
+{
+	opcodeIndex.clear();
+	for (auto& fx : effects) {
+		IndexEffect(&fx, false);
+	}
+}
+
 void EffectQueue::AddEffect(Effect* fx, bool insert)
 {
 	if (insert) {
 		effects.push_front(std::move(*fx));
+		IndexEffect(&effects.front(), true);
 	} else {
 		effects.push_back(std::move(*fx));
+		IndexEffect(&effects.back(), false);
 	}
 	delete fx;
 }
@@ -437,6 +522,7 @@ bool EffectQueue::RemoveEffect(const Effect* fx)
 {
 	for (auto f = effects.begin(); f != effects.end(); ++f) {
 		if (*fx == *f) {
+			UnindexEffect(&*f);
 			effects.erase(f);
 			return true;
 		}
@@ -452,24 +538,41 @@ void EffectQueue::ApplyAllEffects(Actor* target)
 	const auto& Opcodes = Globals::Get().Opcodes;
 
 	for (auto& fx : effects) {
+		ieDword opcode = fx.Opcode;
 		if (Opcodes[fx.Opcode].Flags & EFFECT_REINIT_ON_LOAD) {
 			// pretend to be the first application (FirstApply==1)
 			ApplyEffect(target, &fx, 1);
 		} else {
 			ApplyEffect(target, &fx, 0);
 		}
+		// some effects morph into another opcode on their first run
+		if (fx.Opcode != opcode) {
+			ReindexOpcode(opcode);
+			ReindexOpcode(fx.Opcode);
+		}
 	}
 }
 
 void EffectQueue::Cleanup()
 {
+	bool expired = false;
 	for (auto f = effects.begin(); f != effects.end(); ) {
 		if (f->TimingMode == FX_DURATION_JUST_EXPIRED) {
 			f = effects.erase(f);
+			expired = true;
 		} else {
 			++f;
 		}
 	}
+	if (!expired) return;
+
+	// drop the dangling entries in one pass over the index, keeping the order
+	for (auto& bucket : opcodeIndex) {
+		bucket.clear();
+	}
+	for (auto& fx : effects) {
+		IndexEffect(&fx, false);
+	}
 }
 
 //Handle the target flag when the effect is applied first
@@ -1312,7 +1415,7 @@ static inline bool IsLive(ieByte timingmode)
 //will be killed along with it
 void EffectQueue::RemoveAllEffects(ieDword opcode)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1423,7 +1526,7 @@ void EffectQueue::RemoveAllEffects(EffectRef &effect_reference)
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithResource(ieDword opcode, const ResRef &resource)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Resource != resource) { continue; }
@@ -1442,7 +1545,7 @@ void EffectQueue::RemoveAllEffectsWithResource(EffectRef &effect_reference, cons
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithSource(ieDword opcode, const ResRef &source, int mode)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		if (fx.SourceRef != source) continue;
 
@@ -1473,7 +1576,7 @@ void EffectQueue::RemoveAllEffectsWithSource(EffectRef &effectReference, const R
 //(works only if a higher stat means good for the target)
 void EffectQueue::RemoveAllDetrimentalEffects(ieDword opcode, ieDword current)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1507,7 +1610,7 @@ void EffectQueue::RemoveAllDetrimentalEffects(EffectRef &effect_reference, ieDwo
 //opcode need to be removed (see removal of portrait icon)
 void EffectQueue::RemoveAllEffectsWithParam(ieDword opcode, ieDword param2)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1526,7 +1629,7 @@ void EffectQueue::RemoveAllEffectsWithParam(EffectRef &effect_reference, ieDword
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithParamAndResource(ieDword opcode, ieDword param2, const ResRef &resource)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1639,7 +1742,7 @@ void EffectQueue::DispelEffects(const Effect *dispeller, ieDword level)
 
 const Effect *EffectQueue::HasOpcode(ieDword opcode) const
 {
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1659,7 +1762,7 @@ const Effect *EffectQueue::HasEffect(EffectRef &effect_reference) const
 
 Effect *EffectQueue::HasOpcode(ieDword opcode)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1679,7 +1782,7 @@ Effect *EffectQueue::HasEffect(EffectRef &effect_reference)
 
 const Effect *EffectQueue::HasOpcodeWithParam(ieDword opcode, ieDword param2) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1704,7 +1807,7 @@ const Effect *EffectQueue::HasEffectWithParam(EffectRef &effect_reference, ieDwo
 
 const Effect *EffectQueue::HasOpcodeWithParamPair(ieDword opcode, ieDword param1, ieDword param2) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1731,7 +1834,7 @@ const Effect *EffectQueue::HasEffectWithParamPair(EffectRef &effect_reference, i
 //this could be used for stoneskins and mirror images as well
 void EffectQueue::DecreaseParam1OfEffect(ieDword opcode, ieDword amount)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		ieDword value = fx.Parameter1;
@@ -1762,7 +1865,7 @@ void EffectQueue::DecreaseParam1OfEffect(EffectRef &effect_reference, ieDword am
 //returns the damage amount NOT soaked
 int EffectQueue::DecreaseParam3OfEffect(ieDword opcode, ieDword amount, ieDword param2)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1801,7 +1904,7 @@ static const int ids_stats[9]={IE_FACTION, IE_TEAM, IE_EA, IE_GENERAL, IE_RACE,
 int EffectQueue::BonusAgainstCreature(ieDword opcode, const Actor *actor) const
 {
 	ieDword sum = 0;
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Parameter1) {
@@ -1853,7 +1956,7 @@ int EffectQueue::BonusAgainstCreature(EffectRef &effect_reference, const Actor *
 int EffectQueue::BonusForParam2(ieDword opcode, ieDword param2) const
 {
 	int sum = 0;
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1875,7 +1978,7 @@ int EffectQueue::MaxParam1(ieDword opcode, bool positive) const
 {
 	int max = 0;
 	ieDwordSigned param1 = 0;
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1898,7 +2001,7 @@ int EffectQueue::MaxParam1(EffectRef &effect_reference, bool positive) const
 
 bool EffectQueue::WeaponImmunity(ieDword opcode, int enchantment, ieDword weapontype) const
 {
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1938,7 +2041,7 @@ void EffectQueue::AddWeaponEffects(EffectQueue* fxqueue, EffectRef& fx_ref, ieDw
 	ieDword opcode = fx_ref.opcode;
 	Point p(-1,-1);
 
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (!param2 && fx.Parameter2 != param2) continue;
@@ -1958,7 +2061,7 @@ int EffectQueue::SumDamageReduction(EffectRef &effect_reference, ieDword weaponE
 	int remaining = 0;
 	int count = 0;
 
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1979,7 +2082,7 @@ int EffectQueue::SumDamageReduction(EffectRef &effect_reference, ieDword weaponE
 //useful for immunity vs spell, can't use item, etc.
 const Effect *EffectQueue::HasOpcodeWithResource(ieDword opcode, const ResRef &resource) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Resource != resource) continue;
@@ -2004,7 +2107,7 @@ const Effect *EffectQueue::HasEffectWithPower(EffectRef &effect_reference, ieDwo
 
 const Effect *EffectQueue::HasOpcodeWithPower(ieDword opcode, ieDword power) const
 {
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		// NOTE: matching greater or equals!
@@ -2032,7 +2135,7 @@ const Effect *EffectQueue::HasSource(const ResRef &removed) const
 //used in contingency/sequencer code (cannot have the same contingency twice)
 const Effect *EffectQueue::HasOpcodeWithSource(ieDword opcode, const ResRef &removed) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (removed != fx.SourceRef) {
@@ -2118,7 +2221,7 @@ ieDword EffectQueue::CountEffects(ieDword opcode, ieDword param1, ieDword param2
 {
 	ieDword cnt = 0;
 
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		if( param1!=0xffffffff)
 			MATCH_PARAM1()
@@ -2135,7 +2238,7 @@ unsigned int EffectQueue::GetEffectOrder(EffectRef& effect_reference, const Effe
 	ieDword cnt = 1;
 	ieDword opcode = ResolveEffect(effect_reference);
 
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (&fx == fx2) break;
@@ -2146,7 +2249,7 @@ unsigned int EffectQueue::GetEffectOrder(EffectRef& effect_reference, const Effe
 
 void EffectQueue::ModifyEffectPoint(ieDword opcode, ieDword x, ieDword y)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsOf(opcode)) {
 		MATCH_OPCODE()
 		fx.Pos = Point(x, y);
 		fx.Parameter3 = 0;
@@ -37,6 +37,7 @@
 
 #include <cstdlib>
 #include <list>
+#include <vector>
 
 namespace GemRB {
 
@@ -217,11 +218,38 @@ private:
 	/** List of Effects applied on the Actor */
 	using queue_t = std::list<Effect>;
 	queue_t effects;
+	/** Effects of each opcode, in queue order
+	 * list nodes never move, so the pointers stay valid until the effect is erased */
+	using bucket_t = std::vector<Effect*>;
+	std::vector<bucket_t> opcodeIndex;
 	/** Actor which is target of the Effects */
 	Scriptable* Owner = nullptr;
 
+	/** iterates over one opcode bucket, yielding effects like the queue itself */
+	template <typename FX>
+	class OpcodeView {
+		const bucket_t& bucket;
+	public:
+		class iterator {
+			bucket_t::const_iterator it;
+		public:
+			explicit iterator(bucket_t::const_iterator it) : it(it) {}
+			FX& operator*() const { return **it; }
+			iterator& operator++() { ++it; return *this; }
+			bool operator!=(const iterator& other) const { return it != other.it; }
+		};
+
+		explicit OpcodeView(const bucket_t& bucket) : bucket(bucket) {}
+		iterator begin() const { return iterator(bucket.begin()); }
+		iterator end() const { return iterator(bucket.end()); }
+	};
+
 public:
 	EffectQueue() noexcept {};
+	EffectQueue(const EffectQueue& other);
+	EffectQueue(EffectQueue&&) = default;
+	EffectQueue& operator=(const EffectQueue& other);
+	EffectQueue& operator=(EffectQueue&&) = default;
 	
 	explicit operator bool() const {
 		return !effects.empty();
@@ -343,6 +371,12 @@ public:
 	bool HasHostileEffects() const;
 	static bool CheckIWDTargeting(Scriptable* Owner, Actor* target, ieDword value, ieDword type, Effect *fx = nullptr);
 private:
+	OpcodeView<Effect> EffectsOf(ieDword opcode);
+	OpcodeView<const Effect> EffectsOf(ieDword opcode) const;
+	void IndexEffect(Effect* fx, bool insert);
+	void UnindexEffect(const Effect* fx);
+	void ReindexOpcode(ieDword opcode);
+	void RebuildIndex();
 	/** counts effects of specific opcode, parameters and resource */
 	ieDword CountEffects(ieDword opcode, ieDword param1, ieDword param2, const ResRef& = ResRef()) const;
 	void ModifyEffectPoint(ieDword opcode, ieDword x, ieDword y);
@@ -31,6 +31,8 @@ Factory::~Factory(void)
 
 void Factory::AddFactoryObject(FactoryObject* fobject)
 {
+	// the first one wins, like the lookup always did
+	index[fobject->SuperClassID].emplace(fobject->resRef, int(fobjects.size()));
 	fobjects.push_back( fobject );
 }
 
@@ -40,14 +42,15 @@ int Factory::IsLoaded(const ResRef& resref, SClass_ID type) const
 		return -1;
 	}
 
-	for (unsigned int i = 0; i < fobjects.size(); i++) {
-		if (fobjects[i]->SuperClassID == type) {
-			if (fobjects[i]->resRef == resref) {
-				return i;
-			}
-		}
+	auto byType = index.find(type);
+	if (byType == index.end()) {
+		return -1;
+	}
+	auto it = byType->second.find(resref);
+	if (it == byType->second.end()) {
+		return -1;
 	}
-	return -1;
+	return it->second;
 }
 
 FactoryObject* Factory::GetFactoryObject(int pos) const
@@ -27,11 +27,15 @@
 #include "AnimationFactory.h"
 #include "FactoryObject.h"
 
+#include <unordered_map>
+
 namespace GemRB {
 
 class GEM_EXPORT Factory {
 private:
 	std::vector< FactoryObject*> fobjects;
+	// positions in fobjects, per type
+	std::unordered_map<SClass_ID, ResRefMap<int>> index;
 public:
 	Factory() noexcept = default;
 	Factory(const Factory&) = delete;
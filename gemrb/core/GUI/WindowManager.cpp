@@ -21,6 +21,7 @@
 #include "GameData.h"
 #include "Interface.h"
 #include "ImageMgr.h"
+#include "Profiler.h"
 #include "Window.h"
 #include "GUI/GameControl.h"
 
@@ -568,6 +569,7 @@ WindowManager::HUDLock WindowManager::DrawHUD() const
 
 void WindowManager::DrawWindows() const
 {
+	ProfileZone zone("DrawWindows");
 	HUDBuf->Clear();
 
 	if (windows.empty()) {
@@ -817,6 +817,21 @@ void Game::PlacePersistents(Map *newMap, const ResRef &resRef)
 	}
 }
 
+ResourcePreloader::Ticket Game::PreloadMap(const ResRef &resRef, int priority)
+{
+	if (FindMap(resRef) >= 0) {
+		return ResourcePreloader::NoTicket;
+	}
+
+	// the area itself is left alone, LoadMap may still extract a newer one from the save
+	DataStream* ds = gamedata->GetResource(resRef, IE_ARE_CLASS_ID, true);
+	auto mM = GetImporter<MapMgr>(IE_ARE_CLASS_ID, ds);
+	if (!mM) {
+		return ResourcePreloader::NoTicket;
+	}
+	return mM->PreloadResources(IsDay(), priority);
+}
+
 /* Loads an area */
 int Game::LoadMap(const ResRef &resRef, bool loadscreen)
 {
@@ -872,6 +887,8 @@ int Game::LoadMap(const ResRef &resRef, bool loadscreen)
 	}
 
 	core->GetAudioDrv()->UpdateMapAmbient(newMap->reverb);
+	newMap->PrefetchSounds();
+	gamedata->LogCacheStats();
 
 	core->LoadProgress(100);
 	return ret;
@@ -34,6 +34,7 @@
 
 #include "Callback.h"
 #include "Resource.h"
+#include "ResourcePreloader.h"
 #include "Scriptable/Scriptable.h"
 #include "Scriptable/PCStatStruct.h"
 #include "Variables.h"
@@ -356,6 +357,8 @@ public:
 	 * don't load it again, set changepf == true,
 	 * if you want to change the pathfinder too. */
 	int LoadMap(const ResRef &ResRef, bool loadscreen);
+	/* reads the bulk of an area's resources in the background, so a later LoadMap is quicker */
+	ResourcePreloader::Ticket PreloadMap(const ResRef &resRef, int priority);
 	int DelMap(unsigned int index, int forced = 0);
 	int AddNPC(Actor* npc);
 	Actor* GetNPC(unsigned int Index) const;
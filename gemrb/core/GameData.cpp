@@ -64,6 +64,25 @@ static void ReleaseEffect(void *poi)
 	delete ((Effect *) poi);
 }
 
+// rough memory footprints, only used to keep the caches within their budget
+static size_t ItemSize(const Item* item)
+{
+	size_t size = sizeof(Item) + item->equipping_features.size() * sizeof(Effect);
+	for (const ITMExtHeader& header : item->ext_headers) {
+		size += sizeof(ITMExtHeader) + header.features.size() * sizeof(Effect);
+	}
+	return size;
+}
+
+static size_t SpellSize(const Spell* spell)
+{
+	size_t size = sizeof(Spell) + spell->casting_features.size() * sizeof(Effect);
+	for (const SPLExtHeader& header : spell->ext_headers) {
+		size += sizeof(SPLExtHeader) + header.features.size() * sizeof(Effect);
+	}
+	return size;
+}
+
 GEM_EXPORT GameData* gamedata;
 
 GameData::GameData()
@@ -78,6 +97,7 @@ GameData::~GameData()
 
 void GameData::ClearCaches()
 {
+	LogCacheStats();
 	ItemCache.RemoveAll(ReleaseItem);
 	SpellCache.RemoveAll(ReleaseSpell);
 	EffectCache.RemoveAll(ReleaseEffect);
@@ -90,6 +110,37 @@ void GameData::ClearCaches()
 	}
 }
 
+void GameData::SetCacheBudget(size_t bytes)
+{
+	// items are the most numerous, effects just templates
+	ItemCache.SetBudget(bytes / 2, ReleaseItem);
+	SpellCache.SetBudget(bytes / 8 * 3, ReleaseSpell);
+	EffectCache.SetBudget(bytes / 16, ReleaseEffect);
+	paletteBudget = bytes / 16;
+	TrimPalettes(ResRef());
+}
+
+void GameData::TrimCaches()
+{
+	ItemCache.Trim();
+	SpellCache.Trim();
+	EffectCache.Trim();
+}
+
+void GameData::LogCacheStats() const
+{
+	if (!LogEnabled(DEBUG, "GameData")) return;
+
+	auto logStats = [](const char* name, const Cache::Stats& stats, size_t size) {
+		Log(DEBUG, "GameData", "{} cache: {} hits, {} misses, {} evictions, {}kB resident",
+			name, stats.hits, stats.misses, stats.evictions, size / 1024);
+	};
+	logStats("Item", ItemCache.GetStats(), ItemCache.GetSize());
+	logStats("Spell", SpellCache.GetStats(), SpellCache.GetSize());
+	logStats("Effect", EffectCache.GetStats(), EffectCache.GetSize());
+	logStats("Palette", paletteStats, PaletteCache.size() * sizeof(Palette));
+}
+
 Actor* GameData::GetCreature(const ResRef& creature, unsigned int PartySlot)
 {
 	DataStream* ds = GetResource(creature, IE_CRE_CLASS_ID);
@@ -179,22 +230,48 @@ AutoTable GameData::GetTable(const ResRef &resRef) const
 PaletteHolder GameData::GetPalette(const ResRef& resname)
 {
 	auto iter = PaletteCache.find(resname);
-	if (iter != PaletteCache.end())
-		return iter->second;
+	if (iter != PaletteCache.end()) {
+		paletteStats.hits++;
+		iter->second.lastUse = ++paletteUses;
+		return iter->second.palette;
+	}
+	paletteStats.misses++;
 
+	CachedPalette& cached = PaletteCache[resname];
+	cached.lastUse = ++paletteUses;
 	ResourceHolder<ImageMgr> im = GetResourceHolder<ImageMgr>(resname);
-	if (im == nullptr) {
-		PaletteCache[resname] = nullptr;
-		return NULL;
+	if (im) {
+		cached.palette = MakeHolder<Palette>();
+		im->GetPalette(256, cached.palette->col);
+		cached.palette->named = true;
 	}
-
-	PaletteHolder palette = MakeHolder<Palette>();
-	im->GetPalette(256,palette->col);
-	palette->named=true;
-	PaletteCache[resname] = palette;
+	// copy before trimming, which may rehash
+	PaletteHolder palette = cached.palette;
+	TrimPalettes(resname);
 	return palette;
 }
 
+// drops the least recently used palettes nobody else holds
+void GameData::TrimPalettes(const ResRef& keep)
+{
+	if (!paletteBudget) return;
+
+	while (PaletteCache.size() * sizeof(Palette) > paletteBudget) {
+		auto victim = PaletteCache.end();
+		for (auto it = PaletteCache.begin(); it != PaletteCache.end(); ++it) {
+			if (it->first == keep) continue;
+			if (it->second.palette && it->second.palette->GetRefCount() > 1) continue;
+			if (victim == PaletteCache.end() || it->second.lastUse < victim->second.lastUse) {
+				victim = it;
+			}
+		}
+		if (victim == PaletteCache.end()) break;
+
+		PaletteCache.erase(victim);
+		paletteStats.evictions++;
+	}
+}
+
 Item* GameData::GetItem(const ResRef &resname, bool silent)
 {
 	if (resname.IsEmpty()) {
@@ -215,7 +292,7 @@ Item* GameData::GetItem(const ResRef &resname, bool silent)
 	item->Name = resname;
 	sm->GetItem( item );
 
-	ItemCache.SetAt(resname, (void *) item);
+	ItemCache.SetAt(resname, (void *) item, ItemSize(item));
 	return item;
 }
 
@@ -256,7 +333,7 @@ Spell* GameData::GetSpell(const ResRef &resname, bool silent)
 	spell->Name = resname;
 	sm->GetSpell( spell, silent );
 
-	SpellCache.SetAt(resname, (void *) spell);
+	SpellCache.SetAt(resname, (void *) spell, SpellSize(spell));
 	return spell;
 }
 
@@ -273,8 +350,10 @@ void GameData::FreeSpell(const Spell *spl, const ResRef &name, bool free)
 
 Effect* GameData::GetEffect(const ResRef &resname)
 {
+	// only the template is cached, the callers get copies, so no reference is kept
 	const Effect *effect = (const Effect *) EffectCache.GetResource(resname);
 	if (effect) {
+		EffectCache.DecRef(effect, resname, false);
 		return new Effect(*effect);
 	}
 	DataStream* str = GetResource( resname, IE_EFF_CLASS_ID );
@@ -292,8 +371,10 @@ Effect* GameData::GetEffect(const ResRef &resname)
 		return nullptr;
 	}
 
-	EffectCache.SetAt(resname, (void *) effect);
-	return new Effect(*effect);
+	EffectCache.SetAt(resname, (void *) effect, sizeof(Effect));
+	Effect* copy = new Effect(*effect);
+	EffectCache.DecRef(effect, resname, false);
+	return copy;
 }
 
 void GameData::FreeEffect(const Effect *eff, const ResRef &name, bool free)
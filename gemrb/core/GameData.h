@@ -95,6 +95,11 @@ public:
 
 	using index_t = uint16_t;
 	void ClearCaches();
+	/** Limits the memory kept by unused items, spells, effects and palettes */
+	void SetCacheBudget(size_t bytes);
+	/** Enforces the budget, once per tick, when no released item or spell is in use anymore */
+	void TrimCaches();
+	void LogCacheStats() const;
 
 	/** Returns actor */
 	Actor* GetCreature(const ResRef& creature, unsigned int PartySlot = 0);
@@ -180,11 +185,19 @@ public:
 private:
 	void ReadItemSounds();
 	void ReadSpellProtTable();
+	void TrimPalettes(const ResRef& keep);
 private:
 	Cache ItemCache;
 	Cache SpellCache;
 	Cache EffectCache;
-	ResRefMap<PaletteHolder> PaletteCache;
+	struct CachedPalette {
+		PaletteHolder palette;
+		unsigned long lastUse = 0;
+	};
+	ResRefMap<CachedPalette> PaletteCache;
+	unsigned long paletteUses = 0;
+	size_t paletteBudget = 0;
+	Cache::Stats paletteStats;
 	Factory* factory;
 	ResRefMap<AutoTable> tables;
 	using StoreMap = std::map<ResRef, Store*>;
@@ -118,6 +118,7 @@ GEM_EXPORT SrcVector *LoadSrc(const ResRef& resname);
 bool IsInObjectRect(const Point &pos, const Region &rect);
 Action *ParamCopy(const Action *parameters);
 Action *ParamCopyNoOverride(const Action *parameters);
+Trigger *TriggerCopy(const Trigger *trigger);
 GEM_EXPORT void SetVariable(Scriptable* Sender, const StringParam& VarName, ieDword value, VarContext Context = {});
 GEM_EXPORT void SetPointVariable(Scriptable* Sender, const StringParam& VarName, const Point &point, const VarContext& Context = {});
 Point GetEntryPoint(const ResRef& areaname, const ResRef& entryname);
@@ -49,10 +49,13 @@
 #include "GameData.h"
 #include "Interface.h"
 #include "PluginMgr.h"
+#include "Profiler.h"
 #include "TableMgr.h"
 #include "RNG.h"
 
 #include <cstdarg>
+#include <list>
+#include <unordered_map>
 
 namespace GemRB {
 
@@ -1366,9 +1369,56 @@ void Targets::FilterObjectRect(const Object *oC)
 	}
 }
 
+// the parsed form of recently compiled strings, since dialogs and cutscenes repeat them a lot
+template<typename T>
+class ParsedCache {
+	static const size_t Capacity = 1024;
+
+	using Entry = std::pair<std::string, T*>;
+	// most recently used first
+	std::list<Entry> entries;
+	std::unordered_map<std::string, typename std::list<Entry>::iterator> index;
+
+public:
+	// the result stays owned by the cache
+	const T* Get(const std::string& key)
+	{
+		auto it = index.find(key);
+		if (it == index.end()) return nullptr;
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->second;
+	}
+
+	// takes over a reference to parsed
+	void Add(const std::string& key, T* parsed)
+	{
+		if (entries.size() >= Capacity) {
+			entries.back().second->Release();
+			index.erase(entries.back().first);
+			entries.pop_back();
+		}
+		entries.emplace_front(key, parsed);
+		index[key] = entries.begin();
+	}
+
+	void Clear()
+	{
+		for (const auto& entry : entries) {
+			entry.second->Release();
+		}
+		entries.clear();
+		index.clear();
+	}
+};
+
+static ParsedCache<Action> parsedActions;
+static ParsedCache<Trigger> parsedTriggers;
+
 /** releasing global memory */
 static void CleanupIEScript()
 {
+	parsedActions.Clear();
+	parsedTriggers.Clear();
 	triggersTable.reset();
 	actionsTable.reset();
 	objectsTable.reset();
@@ -1835,6 +1885,9 @@ Script* GameScript::CacheScript(const ResRef& resRef, bool AIScript)
 		ResponseBlock* rB = ReadResponseBlock( stream );
 		if (!rB)
 			break;
+		if (rB->condition) {
+			rB->condition->Compile();
+		}
 		newScript->responseBlocks.push_back( rB );
 		stream->ReadLine( line, 10 );
 	}
@@ -2015,6 +2068,8 @@ bool GameScript::Update(bool *continuing, bool *done)
 	if (!MySelf)
 		return false;
 
+	ProfileZone zone("GameScript::Update", StringView(Name.CString()));
+
 	if (!script)
 		return false;
 
@@ -2253,6 +2308,41 @@ int GameScript::EvaluateString(Scriptable* Sender, const char* String)
 	return 0;
 }
 
+static StringView TriggerName(unsigned short triggerID)
+{
+	StringView name = triggersTable->GetValue(triggerID);
+	if (name.empty()) {
+		name = triggersTable->GetValue(triggerID | 0x4000);
+	}
+	return name;
+}
+
+static int CallTrigger(const Trigger* trigger, TriggerFunction func, Scriptable* Sender)
+{
+	// don't bother with the name lookup unless it is going to be printed
+	if (core->InDebugMode(ID_TRIGGERS)) {
+		ScriptDebugLog(ID_TRIGGERS, "Executing trigger code: {:#x} {} (Sender: {} / {})", trigger->triggerID, TriggerName(trigger->triggerID), Sender->GetScriptName(), fmt::WideToChar{Sender->GetName()});
+	}
+
+	int ret = func(Sender, trigger);
+	if (trigger->flags & TF_NEGATE) {
+		return !ret;
+	}
+	// ideally we'd set LastTrigger here, but we need the resolved target object
+
+	return ret;
+}
+
+void Condition::Compile() const
+{
+	functions.resize(triggers.size());
+	for (size_t i = 0; i < triggers.size(); ++i) {
+		unsigned short triggerID = triggers[i]->triggerID;
+		// corrupted and unhandled triggers keep going through Trigger::Evaluate for its warnings
+		functions[i] = triggerID < MAX_TRIGGERS ? GemRB::triggers[triggerID] : nullptr;
+	}
+}
+
 bool Condition::Evaluate(Scriptable *Sender) const
 {
 	int ORcount = 0;
@@ -2262,13 +2352,26 @@ bool Condition::Evaluate(Scriptable *Sender) const
 	if (triggers.empty()) {
 		return true;
 	}
-
-	for (const Trigger *tR : triggers) {
-		//do not evaluate triggers in an Or() block if one of them
-		//was already True() ... but this sane approach was only used in iwd2!
-		if (!core->HasFeature(GF_EFFICIENT_OR) || !ORcount || !subresult) {
-			result = tR->Evaluate(Sender);
+	// conditions from dialogs and stores don't go through the script cache
+	if (functions.size() != triggers.size()) {
+		Compile();
+	}
+
+	//do not evaluate triggers in an Or() block if one of them
+	//was already True() ... but this sane approach was only used in iwd2!
+	bool efficientOr = core->HasFeature(GF_EFFICIENT_OR);
+	for (size_t i = 0; i < triggers.size(); ++i) {
+		if (ORcount && subresult && efficientOr) {
+			// jump over the rest of the block, it can't change the outcome anymore
+			// an unfinished block stops at the end, so it still gets reported below
+			int skip = std::min(ORcount, int(triggers.size() - i));
+			i += skip - 1;
+			ORcount -= skip;
+			continue;
 		}
+
+		TriggerFunction func = functions[i];
+		result = func ? CallTrigger(triggers[i], func, Sender) : triggers[i]->Evaluate(Sender);
 		if (result > 1) {
 			//we started an Or() block
 			if (ORcount) {
@@ -2307,25 +2410,14 @@ int Trigger::Evaluate(Scriptable *Sender) const
 		return 0;
 	}
 	TriggerFunction func = triggers[triggerID];
-	StringView tmpstr = triggersTable->GetValue(triggerID);
-	if (tmpstr.empty()) {
-		tmpstr = triggersTable->GetValue(triggerID|0x4000);
-	}
 	if (!func) {
 		triggers[triggerID] = GameScript::False;
 		Log(WARNING, "GameScript", "Unhandled trigger code: {:#x} {}",
-			triggerID, tmpstr );
+			triggerID, TriggerName(triggerID));
 		return 0;
 	}
-	ScriptDebugLog(ID_TRIGGERS, "Executing trigger code: {:#x} {} (Sender: {} / {})", triggerID, tmpstr, Sender->GetScriptName(), fmt::WideToChar{Sender->GetName()});
 
-	int ret = func( Sender, this );
-	if (flags & TF_NEGATE) {
-		return !ret;
-	}
-	// ideally we'd set LastTrigger here, but we need the resolved target object
-
-	return ret;
+	return CallTrigger(this, func, Sender);
 }
 
 int ResponseSet::Execute(Scriptable* Sender)
@@ -2497,6 +2589,11 @@ Trigger* GenerateTrigger(std::string string)
 	StringToLower(string);
 	ScriptDebugLog(ID_TRIGGERS, "Compiling: {}", string);
 
+	const Trigger* parsed = parsedTriggers.Get(string);
+	if (parsed) {
+		return TriggerCopy(parsed);
+	}
+
 	int negate = 0;
 	strpos_t start = 0;
 	if (string[start] == '!') {
@@ -2516,7 +2613,8 @@ Trigger* GenerateTrigger(std::string string)
 		Log(ERROR, "GameScript", "Malformed scripting trigger: {}", string);
 		return NULL;
 	}
-	return trigger;
+	parsedTriggers.Add(string, trigger);
+	return TriggerCopy(trigger);
 }
 
 Action* GenerateAction(std::string actionString)
@@ -2526,6 +2624,11 @@ Action* GenerateAction(std::string actionString)
 	StringToLower(actionString);
 	ScriptDebugLog(ID_ACTIONS, "Compiling: {}", actionString);
 
+	const Action* parsed = parsedActions.Get(actionString);
+	if (parsed) {
+		return ParamCopy(parsed);
+	}
+
 	auto len = actionString.find_first_of('(') + 1; //including (
 	assert(len != std::string::npos);
 	const char *src = &actionString[len];
@@ -2552,9 +2655,12 @@ Action* GenerateAction(std::string actionString)
 	action = GenerateActionCore( src, str, actionID);
 	if (!action) {
 		Log(ERROR, "GameScript", "Malformed scripting action: {}", actionString);
+		return action;
 	}
 
-	return action;
+	action->IncRef();
+	parsedActions.Add(actionString, action);
+	return ParamCopy(action);
 }
 
 Action *GenerateActionDirect(std::string string, const Scriptable *object)
@@ -36,6 +36,9 @@ namespace GemRB {
 
 class Action;
 class GameScript;
+class Trigger;
+
+using TriggerFunction = int (*)(Scriptable*, const Trigger*);
 
 //escapearea flags
 #define EA_DESTROY 1        //destroy actor at the exit (otherwise move to new place)
@@ -272,8 +275,13 @@ public:
 		delete this;
 	}
 	bool Evaluate(Scriptable *Sender) const;
+	// resolves the trigger functions up front, so evaluation doesn't need the lookup tables
+	void Compile() const;
 
 	std::vector<Trigger*> triggers;
+private:
+	// parallel to triggers, null for the ones that need the checks of Trigger::Evaluate
+	mutable std::vector<TriggerFunction> functions;
 };
 
 class GEM_EXPORT Action final : protected Canary {
@@ -436,7 +444,6 @@ public:
 	}
 };
 
-using TriggerFunction = int (*)(Scriptable*, const Trigger*);
 using ActionFunction = void (*)(Scriptable*, Action*);
 using ObjectFunction = Targets* (*)(const Scriptable*, Targets*, int ga_flags);
 using IDSFunction = int (*)(const Actor*, int parameter);
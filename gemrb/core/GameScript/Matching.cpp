@@ -187,10 +187,24 @@ static Targets *EvaluateObject(const Map *map, const Scriptable *Sender, const O
 	Targets *tgts = NULL;
 
 	//we need to get a subset of actors from the large array
-	//if this gets slow, we will need some index tables
-	int i = map->GetActorCount(true);
+	//actors only match within their visual range (see DoObjectChecks),
+	//so unless there is an object rect, ask the map only for the nearby ones
+	std::vector<Actor*> candidates;
+	const Actor* source = Scriptable::As<Actor>(Sender);
+	if (source && Sender->GetCurrentArea() == map && !(HasAdditionalRect && oC->objectRect.size.Area() > 0)) {
+		int range = static_cast<int>(std::min<ieDword>(source->Modified[IE_VISUALRANGE], 0xffff)) + 1;
+		candidates = map->GetActorCandidates(Sender->Pos, range * 16, range * 12);
+	} else {
+		int count = map->GetActorCount(true);
+		candidates.reserve(count);
+		for (int i = 0; i < count; ++i) {
+			candidates.push_back(map->GetActor(i, true));
+		}
+	}
+
+	size_t i = candidates.size();
 	while (i--) {
-		Actor *ac = map->GetActor(i, true);
+		Actor *ac = candidates[i];
 		if (!ac) continue; // is this check really needed?
 		// don't return Sender in IDS targeting!
 		// unless it's pst, which relies on it in 3012cut2-3012cut7.bcs
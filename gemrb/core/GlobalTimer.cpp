@@ -28,10 +28,8 @@
 
 namespace GemRB {
 
-void GlobalTimer::Freeze()
+void GlobalTimer::Freeze(tick_t thisTime)
 {
-	tick_t thisTime = GetMilliseconds();
-
 	if (UpdateViewport(thisTime) == false) {
 		return;
 	}
@@ -127,12 +125,11 @@ bool GlobalTimer::UpdateViewport(tick_t thisTime)
 	return true;
 }
 
-bool GlobalTimer::Update()
+bool GlobalTimer::Update(tick_t thisTime)
 {
 	Map *map;
 	Game *game;
 	const GameControl* gc;
-	tick_t thisTime = GetMilliseconds();
 
 	if (!startTime) {
 		goto end;
@@ -52,8 +52,11 @@ public:
 	GlobalTimer(GlobalTimer&&) noexcept = default;
 	GlobalTimer& operator=(GlobalTimer&&) noexcept = default;
 
-	void Freeze();
-	bool Update();
+	void Freeze() { Freeze(GetMilliseconds()); }
+	bool Update() { return Update(GetMilliseconds()); }
+	// explicit clock, so the game can also run at a fixed timestep (benchmarks)
+	void Freeze(tick_t thisTime);
+	bool Update(tick_t thisTime);
 	bool ViewportIsMoving() const;
 	void DoStep(int count);
 	void SetMoveViewPort(Point p, int spd, bool center);
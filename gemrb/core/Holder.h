@@ -37,6 +37,7 @@ public:
 		assert(RefCount && "Broken Held usage.");
 		if (--RefCount == 0) delete static_cast<T*>(this);
 	}
+	size_t GetRefCount() const noexcept { return RefCount; }
 private:
 	size_t RefCount = 0;
 };
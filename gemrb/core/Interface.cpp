@@ -50,6 +50,7 @@
 #include "PluginLoader.h"
 #endif
 #include "PluginMgr.h"
+#include "Profiler.h"
 #include "Predicates.h"
 #include "ProjectileServer.h"
 #include "SaveGameIterator.h"
@@ -76,8 +77,12 @@
 #include "RNG.h"
 #include "Scriptable/Container.h"
 #include "Streams/FileStream.h"
+#include "Streams/MemoryStream.h"
 #include "System/FileFilters.h"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -599,6 +604,12 @@ void Interface::DisableMusicPlaylist(size_t SongType)
 /** this is the main loop */
 void Interface::Main()
 {
+	if (config.BenchmarkTicks > 0) {
+		RunBenchmark();
+		QuitGame(0);
+		return;
+	}
+
 	ieDword speed = 10;
 
 	vars->Lookup("Mouse Scroll Speed", speed);
@@ -618,6 +629,7 @@ void Interface::Main()
 	double frames = 0.0;
 
 	do {
+		ProfileZone frameZone("Frame");
 		for (auto it = timers.begin(); it != timers.end();) {
 			if (it->IsRunning()) {
 				it->Update(time);
@@ -812,7 +824,13 @@ int Interface::Init(const InterfaceConfig* cfg)
 	CONFIG_INT("MouseFeedback", config.MouseFeedback =);
 	CONFIG_INT("MultipleQuickSaves", config.MultipleQuickSaves =);
 	CONFIG_INT("RepeatKeyDelay", Control::ActionRepeatDelay =);
+	CONFIG_INT("ResourceCacheSize", config.ResourceCacheSize =);
+	gamedata->SetCacheBudget(size_t(std::max(0, config.ResourceCacheSize)) << 20);
 	CONFIG_INT("SaveAsOriginal", config.SaveAsOriginal =);
+	CONFIG_INT("SaveCompression", config.SaveCompression =);
+	CONFIG_INT("AutoSaveCompression", config.AutoSaveCompression =);
+	CONFIG_INT("BenchmarkTicks", config.BenchmarkTicks =);
+	CONFIG_INT("Profiling", Profiler::SetEnabled);
 	CONFIG_INT("DebugMode", config.debugMode =);
 	int touchInput = -1;
 	CONFIG_INT("TouchInput", touchInput =);
@@ -961,6 +979,7 @@ int Interface::Init(const InterfaceConfig* cfg)
 	CONFIG_STRING("AudioDriver", config.AudioDriverName);
 	CONFIG_STRING("VideoDriver", config.VideoDriverName);
 	CONFIG_STRING("Encoding", config.Encoding);
+	CONFIG_STRING("BenchmarkSave", config.BenchmarkSave);
 #undef CONFIG_STRING
 
 	value = cfg->GetValueForKey("ModPath");
@@ -1015,6 +1034,20 @@ int Interface::Init(const InterfaceConfig* cfg)
 	// potentially disable logging before plugins are loaded (the log file is a plugin)
 	value = cfg->GetValueForKey("Logging");
 	if (value) ToggleLogging(atoi(value));
+	value = cfg->GetValueForKey("LogLevel");
+	if (value) SetLogLevel(log_level(Clamp(atoi(value), int(FATAL), int(DEBUG))));
+	value = cfg->GetValueForKey("LogOwnerLevels");
+	if (value) {
+		// comma separated Owner=level pairs, eg. FindPath=0,GameScript=5
+		for (const auto& pair : Explode<std::string, std::string>(std::string(value), ',')) {
+			size_t eq = pair.find('=');
+			if (eq == std::string::npos) continue;
+			std::string owner = pair.substr(0, eq);
+			TrimString(owner);
+			int level = Clamp(atoi(pair.c_str() + eq + 1), int(FATAL), int(DEBUG));
+			SetOwnerLogLevel(owner, log_level(level));
+		}
+	}
 
 	Log(MESSAGE, "Core", "Starting Plugin Manager...");
 	const PluginMgr *plugin = PluginMgr::Get();
@@ -1478,6 +1511,21 @@ int Interface::Init(const InterfaceConfig* cfg)
 	};
 	EventMgr::RegisterHotKeyCallback(ToggleConsole, ' ', GEM_MOD_CTRL);
 
+	// the first press starts profiling, any further ones dump what was recorded
+	EventMgr::EventCallback DumpProfile = [this](const Event& e) {
+		if (e.type != Event::KeyDown || e.keyboard.repeats != 1) return false;
+
+		if (!Profiler::IsEnabled()) {
+			Profiler::SetEnabled(true);
+			return true;
+		}
+		char path[_MAX_PATH];
+		PathJoin(path, config.GamePath, "gemrb-trace.json", nullptr);
+		Profiler::Dump(path);
+		return true;
+	};
+	EventMgr::RegisterHotKeyCallback(DumpProfile, 'o', GEM_MOD_CTRL);
+
 	return GEM_OK;
 }
 
@@ -2175,6 +2223,7 @@ bool Interface::IsFreezed() const
 
 void Interface::GameLoop(void)
 {
+	ProfileZone zone("GameLoop");
 	update_scripts = false;
 	GameControl *gc = GetGameControl();
 	if (gc) {
@@ -2193,6 +2242,111 @@ void Interface::GameLoop(void)
 			game->UpdateScripts();
 		}
 	}
+	gamedata->TrimCaches();
+}
+
+// mirrors Main and GameLoop, but advances the clock by exactly one tick per iteration
+// instead of waiting for it, so the run is as fast and as repeatable as possible
+void Interface::RunBenchmark()
+{
+	Holder<SaveGame> save = sgiterator->GetSaveGame(config.BenchmarkSave);
+	if (!save) {
+		Log(ERROR, "Benchmark", "Could not find the save '{}'!", config.BenchmarkSave);
+		return;
+	}
+
+	// go straight into the game, the main menu (and its intro movies) would only get in the way
+	QuitFlag &= ~QF_CHANGESCRIPT;
+	SetupLoadGame(save, 0);
+	QuitFlag |= QF_ENTERGAME;
+	HandleFlags();
+	if (!game || !gamectrl) {
+		Log(ERROR, "Benchmark", "Failed to enter the game from '{}'!", config.BenchmarkSave);
+		return;
+	}
+
+	using clock = std::chrono::steady_clock;
+	struct Phase {
+		const char* name;
+		clock::duration total {};
+		clock::duration worst {};
+
+		explicit Phase(const char* name) : name(name) {}
+		void Add(clock::duration d) {
+			total += d;
+			worst = std::max(worst, d);
+		}
+	};
+	Phase events { "events" };
+	Phase timing { "timer" }; // fog, effects and game time
+	Phase scripts { "scripts" }; // game and area scripts, actions, pathfinding
+	Phase drawing { "draw" };
+
+	const tick_t interval = Time.Ticks2Ms(1);
+	tick_t now = GetMilliseconds();
+	int ticks = 0;
+	clock::time_point start = clock::now();
+	for (; ticks < config.BenchmarkTicks; ++ticks) {
+		while (QuitFlag && QuitFlag != QF_KILL) {
+			HandleFlags();
+		}
+		// death, the end of the game or similar
+		if (!game || !gamectrl || (QuitFlag & QF_KILL)) break;
+
+		ProfileZone tickZone("Tick");
+		clock::time_point t0 = clock::now();
+		if (EventFlag) {
+			HandleEvents();
+		}
+		HandleGUIBehaviour(gamectrl);
+
+		clock::time_point t1 = clock::now();
+		update_scripts = !(gamectrl->GetDialogueFlags() & DF_FREEZE_SCRIPTS);
+		bool doUpdate = false;
+		if (update_scripts) {
+			doUpdate = timer.Update(now);
+		} else {
+			timer.Freeze(now);
+		}
+
+		clock::time_point t2 = clock::now();
+		if (!game->selected.empty()) {
+			gamectrl->ChangeMap(GetFirstSelectedPC(true), false);
+		}
+		if (doUpdate) {
+			game->UpdateScripts();
+		}
+		gamedata->TrimCaches();
+
+		clock::time_point t3 = clock::now();
+		GlobalColorCycle.AdvanceTime(now);
+		winmgr->DrawWindows();
+		video->SwapBuffers(0);
+
+		clock::time_point t4 = clock::now();
+		events.Add(t1 - t0);
+		timing.Add(t2 - t1);
+		scripts.Add(t3 - t2);
+		drawing.Add(t4 - t3);
+		now += interval;
+	}
+
+	using ms = std::chrono::duration<double, std::milli>;
+	using us = std::chrono::duration<double, std::micro>;
+	double elapsed = ms(clock::now() - start).count();
+	Log(MESSAGE, "Benchmark", "Simulated {} of {} ticks in {:.1f} ms ({:.1f} ticks/s).",
+		ticks, config.BenchmarkTicks, elapsed, elapsed > 0 ? ticks * 1000.0 / elapsed : 0.0);
+	for (const Phase* phase : { &events, &timing, &scripts, &drawing }) {
+		Log(MESSAGE, "Benchmark", "{:8}: {:10.2f} ms total, {:9.1f} us/tick mean, {:9.1f} us max",
+			phase->name, ms(phase->total).count(), ticks ? us(phase->total).count() / ticks : 0.0, us(phase->worst).count());
+	}
+
+	// for a finer breakdown of the last ticks
+	if (Profiler::IsEnabled()) {
+		char path[_MAX_PATH];
+		PathJoin(path, config.GamePath, "gemrb-trace.json", nullptr);
+		Profiler::Dump(path);
+	}
 }
 
 /** handles hardcoded gui behaviour */
@@ -4069,7 +4223,7 @@ static bool IsBlobSaveItem(const char *path) {
 	return areExt != nullptr && path + pathLength - 4 == areExt;
 }
 
-int Interface::CompressSave(const char *folder, bool overrideRunning)
+int Interface::CompressSave(const char *folder, bool overrideRunning, int level)
 {
 	FileStream str;
 
@@ -4091,6 +4245,7 @@ int Interface::CompressSave(const char *folder, bool overrideRunning)
 
 	dir.SetFlags(DirectoryIterator::Files);
 	//.tot and .toh should be saved last, because they are updated when an .are is saved
+	std::vector<std::string> members;
 	int priority=2;
 	while(priority) {
 		do {
@@ -4098,19 +4253,7 @@ int Interface::CompressSave(const char *folder, bool overrideRunning)
 			if (SavedExtension(name)==priority) {
 				char dtmp[_MAX_PATH];
 				dir.GetFullPath(dtmp);
-				FileStream fs;
-				if (!fs.Open(dtmp)) {
-					Log(ERROR, "Interface", "Failed to open \"{}\".", dtmp);
-				}
-
-				if (IsBlobSaveItem(dtmp)) {
-					if (overrideRunning) {
-						saveGameAREExtractor.updateSaveGame(str.GetPos());
-						ai->AddToSaveGameCompressed(&str, &fs);
-					}
-				} else {
-					ai->AddToSaveGame(&str, &fs);
-				}
+				members.emplace_back(dtmp);
 			}
 		} while (++dir);
 		//reopen list for the second round
@@ -4120,6 +4263,53 @@ int Interface::CompressSave(const char *folder, bool overrideRunning)
 		}
 	}
 
+	// deflate the members concurrently into their own buffers, then write them out in order
+	std::vector<std::unique_ptr<MemoryStream>> records(members.size());
+	std::vector<char> opened(members.size(), true);
+	std::atomic<size_t> nextMember {0};
+	auto work = [&]() {
+		PluginHolder<ArchiveImporter> archiver = MakePluginHolder<ArchiveImporter>(IE_SAV_CLASS_ID);
+		size_t idx;
+		while ((idx = nextMember++) < members.size()) {
+			if (IsBlobSaveItem(members[idx].c_str())) continue;
+
+			FileStream fs;
+			opened[idx] = fs.Open(members[idx].c_str());
+			records[idx] = make_unique<MemoryStream>(members[idx].c_str(), nullptr, 0);
+			archiver->AddToSaveGame(records[idx].get(), &fs, level);
+		}
+	};
+
+	size_t workerCount = std::min<size_t>(std::thread::hardware_concurrency(), members.size());
+	std::vector<std::thread> workers;
+	for (size_t i = 1; i < workerCount; ++i) {
+		workers.emplace_back(work);
+	}
+	work();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	for (size_t i = 0; i < members.size(); ++i) {
+		if (!opened[i]) {
+			Log(ERROR, "Interface", "Failed to open \"{}\".", members[i]);
+		}
+
+		if (IsBlobSaveItem(members[i].c_str())) {
+			if (overrideRunning) {
+				FileStream fs;
+				if (!fs.Open(members[i].c_str())) {
+					Log(ERROR, "Interface", "Failed to open \"{}\".", members[i]);
+				}
+				saveGameAREExtractor.updateSaveGame(str.GetPos());
+				ai->AddToSaveGameCompressed(&str, &fs);
+			}
+		} else {
+			records[i]->Rewind();
+			ai->AddToSaveGameCompressed(&str, records[i].get());
+		}
+	}
+
 	tick_t endTime = GetMilliseconds();
 	Log(WARNING, "Core", "{} ms (compressing SAV file)", endTime - startTime);
 	return GEM_OK;
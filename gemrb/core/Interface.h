@@ -337,13 +337,18 @@ struct CFGConfigData {
 	int debugMode = 0;
 	bool CheatFlag = false; /** Cheats enabled? */
 	int MaxPartySize = 6;
+	int ResourceCacheSize = 32; // MB of unused items, spells etc. to keep around; 0 keeps all
 
 	bool KeepCache = false;
 	bool MultipleQuickSaves = false;
 	// once GemRB own format is working well, this might be set to 0
 	int SaveAsOriginal = 1; // if true, saves files in compatible mode
+	int SaveCompression = 9; // zlib level used for saves made by the player
+	int AutoSaveCompression = 9; // zlib level used for auto, quick and final saves
 	std::string VideoDriverName = "sdl"; // consider deprecating? It's now a hidden option
 	std::string AudioDriverName = "openal";
+	std::string BenchmarkSave; // save to load for a headless benchmark run
+	int BenchmarkTicks = 0; // ticks to simulate in it, 0 runs the game normally
 };
 
 /**
@@ -680,7 +685,7 @@ public:
 	/** saves the worldmap object to the destination folder */
 	int WriteWorldMap(const char *folder);
 	/** saves the .are and .sto files to the destination folder */
-	int CompressSave(const char *folder, bool overrideRunning);
+	int CompressSave(const char *folder, bool overrideRunning, int level);
 	/** toggles the pause. returns either PAUSE_ON or PAUSE_OFF to reflect the script state after toggling. */
 	PauseSetting TogglePause() const;
 	/** returns true the passed pause setting was applied. false otherwise. */
@@ -757,6 +762,8 @@ private:
 	GameControl* StartGameControl();
 	/** Executes everything (non graphical) in the main game loop */
 	void GameLoop(void);
+	/** Loads the benchmark save and runs it headless at a fixed timestep */
+	void RunBenchmark();
 	/** the internal (without cache) part of GetListFrom2DA */
 	std::vector<ieDword>* GetListFrom2DAInternal(const ResRef& resref);
 
@@ -80,6 +80,12 @@ CFGConfig::CFGConfig(int argc, char *argv[])
 		} else if (stricmp(argv[i], "-q") == 0) {
 			// quiet mode
 			SetKeyValuePair("AudioDriver", "none");
+		} else if (stricmp(argv[i], "-b") == 0 && i + 2 < argc) {
+			// headless benchmark: load the save and run a fixed number of ticks
+			SetKeyValuePair("BenchmarkSave", argv[++i]);
+			SetKeyValuePair("BenchmarkTicks", argv[++i]);
+			SetKeyValuePair("VideoDriver", "none");
+			SetKeyValuePair("AudioDriver", "none");
 		} else {
 			// assume a path was passed, soft force configless startup
 			SetKeyValuePair("GamePath", argv[i]);
@@ -914,6 +914,7 @@ bool Inventory::EquipItem(ieDword slot)
 	}
 	
 	Owner->ClearCurrentStanceAnims();
+	Owner->InvalidateStats();
 	
 	int armorLevel = itm->AnimationType[0] - '1';
 	switch (effect) {
@@ -1007,6 +1008,7 @@ bool Inventory::UnEquipItem(ieDword slot, bool removecurse) const
 	}
 	
 	Owner->ClearCurrentStanceAnims();
+	Owner->InvalidateStats();
 	item->Flags &= ~IE_INV_ITEM_EQUIPPED; //no idea if this is needed, won't hurt
 	return true;
 }
@@ -1227,6 +1229,10 @@ int Inventory::GetEquippedSlot() const
 bool Inventory::SetEquippedSlot(ieWordSigned slotcode, ieWord header, bool noFX)
 {
 	EquippedHeader = header;
+	// the weapon affects the derived stats even without equipping effects
+	if (Owner) {
+		Owner->InvalidateStats();
+	}
 	
 	//doesn't work if magic slot is used, refresh the magic slot just in case
 	if (MagicSlotEquipped() && (slotcode!=SLOT_MAGIC-SLOT_MELEE)) {
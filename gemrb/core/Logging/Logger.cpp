@@ -29,21 +29,32 @@ Logger::Logger(std::deque<WriterPtr> writers)
 {
 	loggingThread = std::thread([this] {
 		while (running) {
-			QueueType queue;
-			std::unique_lock<std::mutex> lk(queueLock);
-			cv.wait(lk, [this]() { return !messageQueue.empty() || !running; });
-			queue.swap(messageQueue);
-			lk.unlock();
-			ProcessMessages(std::move(queue));
+			QueueNode* queue = TakeMessages();
+			if (queue) {
+				ProcessMessages(queue);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lk(sleepLock);
+			sleeping = true;
+			cv.wait(lk, [this]() { return queueHead != nullptr || !running; });
+			sleeping = false;
 		}
+		// flush anything logged during shutdown
+		ProcessMessages(TakeMessages());
 	});
 }
 
 Logger::~Logger()
 {
 	running = false;
-	cv.notify_all();
+	{
+		std::lock_guard<std::mutex> l(sleepLock);
+		cv.notify_all();
+	}
 	loggingThread.join();
+	// late stragglers
+	ProcessMessages(TakeMessages());
 }
 
 void Logger::AddLogWriter(WriterPtr writer)
@@ -52,14 +63,30 @@ void Logger::AddLogWriter(WriterPtr writer)
 	writers.push_back(std::move(writer));
 }
 
-void Logger::ProcessMessages(QueueType queue)
+// detaches all pending messages, oldest first
+Logger::QueueNode* Logger::TakeMessages()
+{
+	QueueNode* node = queueHead.exchange(nullptr);
+	QueueNode* queue = nullptr;
+	while (node) {
+		QueueNode* next = node->next;
+		node->next = queue;
+		queue = node;
+		node = next;
+	}
+	return queue;
+}
+
+void Logger::ProcessMessages(QueueNode* queue)
 {
 	std::lock_guard<std::mutex> l(writerLock);
-	while (!queue.empty()) {
+	while (queue) {
 		for (const auto& writer : writers) {
-			writer->WriteLogMessage(queue.front());
+			writer->WriteLogMessage(queue->msg);
 		}
-		queue.pop_front();
+		QueueNode* next = queue->next;
+		delete queue;
+		queue = next;
 	}
 }
 
@@ -81,9 +108,15 @@ void Logger::LogMsg(LogMessage&& msg)
 			writer->WriteLogMessage(msg);
 		}
 	} else {
-		std::lock_guard<std::mutex> l(queueLock);
-		messageQueue.push_back(std::move(msg));
-		cv.notify_all();
+		QueueNode* node = new QueueNode(std::move(msg));
+		node->next = queueHead.load(std::memory_order_relaxed);
+		while (!queueHead.compare_exchange_weak(node->next, node)) {}
+
+		// only bother with the lock if the logging thread may be waiting
+		if (sleeping) {
+			std::lock_guard<std::mutex> l(sleepLock);
+			cv.notify_one();
+		}
 	}
 }
 
@@ -94,18 +94,27 @@ public:
 
 	using WriterPtr = std::shared_ptr<LogWriter>;
 private:
-	using QueueType = std::deque<LogMessage>;
-	QueueType messageQueue;
+	struct QueueNode {
+		LogMessage msg;
+		QueueNode* next = nullptr;
+
+		explicit QueueNode(LogMessage&& msg) : msg(std::move(msg)) {}
+	};
+	// lock-free multi producer, single consumer queue: producers push onto this stack
+	// and the logging thread takes it all at once, restoring the order
+	std::atomic<QueueNode*> queueHead {nullptr};
 	std::deque<WriterPtr> writers;
 	
 	std::atomic_bool running {true};
+	std::atomic_bool sleeping {false};
 	std::condition_variable cv;
-	std::mutex queueLock;
+	std::mutex sleepLock;
 	std::mutex writerLock;
 	std::thread loggingThread;
 	
 	void threadLoop();
-	void ProcessMessages(QueueType queue);
+	QueueNode* TakeMessages();
+	void ProcessMessages(QueueNode* queue);
 	
 public:
 	explicit Logger(std::deque<WriterPtr>);
@@ -26,6 +26,8 @@
 
 #include <cstdarg>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #ifndef STATIC_LINK
@@ -38,6 +40,20 @@ namespace GemRB {
 using LogMessage = Logger::LogMessage;
 
 static std::atomic<log_level> CWLL;
+static std::atomic<log_level> writerLevel { DEBUG };
+
+// whether the console text area was there the last time we looked
+static std::atomic_bool consoleWinPresent { true };
+// console messages dropped since, so we look for it again every now and then
+static std::atomic<unsigned int> consoleWinMisses { 0 };
+
+// per owner overrides of writerLevel, rarely used, so they get checked only if present
+// readers only load the current snapshot; setters copy it and keep the old ones alive,
+// since another thread may still be looking at them
+using OwnerLevels = std::unordered_map<std::string, log_level>;
+static std::atomic<const OwnerLevels*> ownerLevels { nullptr };
+static std::mutex ownerLevelLock;
+static std::vector<std::unique_ptr<const OwnerLevels>> ownerLevelSnapshots;
 
 std::deque<Logger::WriterPtr> writers;
 
@@ -57,6 +73,7 @@ static void ConsoleWinLogMsg(const LogMessage& msg)
 	if (msg.level > CWLL || msg.level < INTERNAL) return;
 	
 	TextArea* ta = GetControl<TextArea>("CONSOLE", 1);
+	consoleWinPresent = ta != nullptr;
 	
 	if (ta) {
 		static const wchar_t* colors[] = {
@@ -105,12 +122,58 @@ void SetConsoleWindowLogLevel(log_level level)
 		ConsoleWinLogMsg(onMsg);
 	}
 	CWLL = level;
+	consoleWinPresent = true;
+}
+
+void SetLogLevel(log_level level)
+{
+	writerLevel = level;
+}
+
+void SetOwnerLogLevel(const std::string& owner, log_level level)
+{
+	std::lock_guard<std::mutex> l(ownerLevelLock);
+	const OwnerLevels* current = ownerLevels;
+	auto levels = current ? GemRB::make_unique<OwnerLevels>(*current) : GemRB::make_unique<OwnerLevels>();
+	(*levels)[owner] = level;
+	ownerLevels = levels.get();
+	ownerLevelSnapshots.push_back(std::move(levels));
+}
+
+static bool WritersWant(log_level level, const char* owner)
+{
+	if (level <= FATAL) return true; // can't be suppressed
+
+	const OwnerLevels* levels = ownerLevels;
+	if (levels && owner) {
+		auto it = levels->find(owner);
+		if (it != levels->end()) {
+			return level <= it->second;
+		}
+	}
+	return level <= writerLevel;
+}
+
+// the console window comes and goes with the game, so a miss isn't final
+static bool ConsoleWinWants(log_level level)
+{
+	if (level > CWLL) return false;
+	if (consoleWinPresent) return true;
+	if (++consoleWinMisses % 64) return false;
+
+	consoleWinPresent = GetControl<TextArea>("CONSOLE", 1) != nullptr;
+	return consoleWinPresent;
+}
+
+bool LogLevelEnabled(log_level level, const char* owner)
+{
+	return ConsoleWinWants(level) || (logger && WritersWant(level, owner));
 }
 
 void LogMsg(LogMessage&& msg)
 {
 	ConsoleWinLogMsg(msg);
-	if (logger) {
+	if (logger && WritersWant(msg.level, msg.owner.c_str())) {
 		logger->LogMsg(std::move(msg));
 	}
 }
@@ -33,16 +33,39 @@
 
 #include <cstdarg>
 
+// the most verbose level that is compiled in at all, eg. 3 drops COMBAT and DEBUG messages
+#ifndef GEMRB_LOG_MIN_LEVEL
+#define GEMRB_LOG_MIN_LEVEL 5
+#endif
+
+#if GEMRB_LOG_MIN_LEVEL < 0
+#error "GEMRB_LOG_MIN_LEVEL can't suppress fatal messages!"
+#endif
+
 namespace GemRB {
 
 GEM_EXPORT void ToggleLogging(bool);
 GEM_EXPORT void AddLogWriter(Logger::WriterPtr&&);
 GEM_EXPORT void SetConsoleWindowLogLevel(log_level level);
+/** sets the most verbose level passed on to the log writers */
+GEM_EXPORT void SetLogLevel(log_level level);
+/** overrides the log level for messages from a single owner */
+GEM_EXPORT void SetOwnerLogLevel(const std::string& owner, log_level level);
+GEM_EXPORT bool LogLevelEnabled(log_level level, const char* owner);
 GEM_EXPORT void LogMsg(Logger::LogMessage&& msg);
 
+/** returns false if nobody would see the message, use it to skip expensive log arguments */
+inline bool LogEnabled(log_level level, const char* owner)
+{
+	return level <= GEMRB_LOG_MIN_LEVEL && LogLevelEnabled(level, owner);
+}
+
 template<typename... ARGS>
 void Log(log_level level, const char* owner, const char* message, ARGS&&... args)
 {
+	// check before formatting, most debug messages are never shown
+	if (!LogEnabled(level, owner)) return;
+
 	auto formattedMsg = fmt::format(message, std::forward<ARGS>(args)...);
 	LogMsg(Logger::LogMessage(level, owner, std::move(formattedMsg), WHITE));
 }
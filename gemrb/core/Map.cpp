@@ -35,6 +35,7 @@
 #include "Palette.h"
 #include "Particles.h"
 #include "PluginMgr.h"
+#include "Profiler.h"
 #include "Projectile.h"
 #include "SaveGameIterator.h"
 #include "ScriptedAnimation.h"
@@ -42,6 +43,7 @@
 #include "VEFObject.h"
 #include "Video/Video.h"
 #include "strrefs.h"
+#include "voodooconst.h"
 #include "ie_cursors.h"
 #include "GameScript/GSUtils.h"
 #include "GUI/GameControl.h"
@@ -405,6 +407,7 @@ reverb(*this)
 {
 	area = this;
 	MasterArea = core->GetGame()->MasterArea(scriptName);
+	RebuildActorIndex();
 }
 
 Map::~Map(void)
@@ -415,6 +418,10 @@ Map::~Map(void)
 		core->CloseCurrentContainer();
 	}
 
+	for (const auto& preload : preloads) {
+		gamedata->CancelPreload(preload.second.ticket);
+	}
+
 	delete TMap;
 	delete INISpawn;
 
@@ -454,6 +461,8 @@ Map::~Map(void)
 void Map::SetTileMapProps(TileProps props)
 {
 	tileProps = std::move(props);
+	RebuildActorIndex();
+	InvalidateLOS();
 }
 
 void Map::AutoLockDoors() const
@@ -607,6 +616,159 @@ void Map::UseExit(Actor *actor, InfoPoint *ip)
 	}
 }
 
+// start loading the area behind a travel region while the party is still walking up to it
+void Map::PreloadDestination(const InfoPoint *ip)
+{
+	static const unsigned int preloadDistance = 400;
+	// a bit further, so walking along the edge doesn't keep restarting it
+	static const unsigned int dropDistance = preloadDistance * 3 / 2;
+
+	if (ip->Destination.IsEmpty()) {
+		return;
+	}
+	const Game* game = core->GetGame();
+	unsigned int distance = dropDistance + 1;
+	for (int i = 0; i < game->GetPartySize(false); ++i) {
+		const Actor* pc = game->GetPC(i, false);
+		if (pc->GetCurrentArea() == this) {
+			distance = std::min(distance, Distance(pc->Pos, ip));
+		}
+	}
+	if (distance > dropDistance) {
+		return;
+	}
+
+	auto it = preloads.find(ip->Destination);
+	if (it != preloads.end()) {
+		it->second.inRange = true;
+		// once the area was loaded, this is spent; start over if it gets unloaded again
+		if (it->second.ticket == ResourcePreloader::NoTicket || gamedata->PreloadPending(it->second.ticket)) {
+			return;
+		}
+		preloads.erase(it);
+	}
+	if (distance > preloadDistance) {
+		return;
+	}
+
+	// the closer the party, the sooner it will be needed
+	Preload& preload = preloads[ip->Destination];
+	preload.ticket = core->GetGame()->PreloadMap(ip->Destination, -int(distance));
+	preload.inRange = true;
+}
+
+// let go of the areas the party walked away from, they hold on to a lot of memory
+void Map::DropStalePreloads()
+{
+	for (auto it = preloads.begin(); it != preloads.end();) {
+		if (it->second.inRange) {
+			it->second.inRange = false;
+			++it;
+			continue;
+		}
+		gamedata->CancelPreload(it->second.ticket);
+		it = preloads.erase(it);
+	}
+}
+
+// how far from an actor Entered may still consider it inside; generous,
+// since Entered does the exact checks (and pst triples the operating distance)
+static int RegionReachMargin(const Actor* actor)
+{
+	return int(MAX_OPERATING_DISTANCE) * 3 + actor->circleSize * 10;
+}
+
+// the rectangles any Entered check of the region can succeed in, before the margin
+static void RegionReachRects(const InfoPoint* ip, std::vector<Region>& rects)
+{
+	Region box = ip->outline ? ip->outline->BBox : ip->BBox;
+	if (!box.size.IsInvalid()) {
+		box.ExpandAllSides(1);
+		rects.push_back(box);
+	}
+	if (ip->Type == ST_TRAVEL) {
+		rects.emplace_back(ip->TrapLaunch, Size(1, 1));
+		rects.emplace_back(ip->TalkPos, Size(1, 1));
+	}
+	// the flags can change, so always include it
+	rects.emplace_back(ip->UsePoint, Size(1, 1));
+}
+
+static bool RegionInReach(const InfoPoint* ip, const Point& pos, int margin)
+{
+	Region box = ip->outline ? ip->outline->BBox : ip->BBox;
+	if (!box.size.IsInvalid()) {
+		box.ExpandAllSides(1);
+		if (box.PointInside(pos)) return true;
+	}
+
+	auto near = [&pos, margin](const Point& p) {
+		return std::abs(p.x - pos.x) <= margin && std::abs(p.y - pos.y) <= margin;
+	};
+	if (ip->Type == ST_TRAVEL && (near(ip->TrapLaunch) || near(ip->TalkPos))) {
+		return true;
+	}
+	return near(ip->UsePoint);
+}
+
+void Map::RebuildRegionIndex()
+{
+	const Size& mapSize = PropsSize();
+	regionIndex.Reset(Size(mapSize.w * 16, mapSize.h * 12));
+	indexedRegions = TMap->GetInfoPointCount();
+	for (size_t i = 0; i < indexedRegions; ++i) {
+		const InfoPoint* ip = TMap->GetInfoPoint(i);
+		if (ip->Type != ST_PROXIMITY && ip->Type != ST_TRAVEL) continue;
+
+		std::vector<Region> rects;
+		RegionReachRects(ip, rects);
+		regionIndex.Insert(i, rects);
+	}
+	++regionGeneration;
+	regionCandidates.resize(indexedRegions);
+}
+
+// instead of checking every region against every actor, only pair the ones close to each other;
+// the candidates are in the order of the script queue, just like a walk over it
+void Map::GatherRegionCandidates()
+{
+	if (indexedRegions != TMap->GetInfoPointCount()) {
+		RebuildRegionIndex();
+	}
+	for (auto& candidates : regionCandidates) {
+		candidates.clear();
+	}
+
+	const auto& scripted = queue[PR_SCRIPT];
+	// forget actors that left, now and then
+	if (actorRegions.size() > 2 * scripted.size() + 32) {
+		actorRegions.clear();
+	}
+
+	size_t q = scripted.size();
+	while (q--) {
+		Actor* actor = scripted[q];
+		RegionReach& reach = actorRegions[actor->GetGlobalID()];
+		if (reach.generation != regionGeneration || reach.pos != actor->Pos || reach.circleSize != actor->circleSize) {
+			reach.pos = actor->Pos;
+			reach.circleSize = actor->circleSize;
+			reach.generation = regionGeneration;
+			reach.regions.clear();
+
+			int margin = RegionReachMargin(actor);
+			Point extent(margin, margin);
+			for (size_t idx : regionIndex.Query(actor->Pos - extent, actor->Pos + extent)) {
+				if (RegionInReach(TMap->GetInfoPoint(idx), actor->Pos, margin)) {
+					reach.regions.push_back(idx);
+				}
+			}
+		}
+		for (size_t idx : reach.regions) {
+			regionCandidates[idx].push_back(actor);
+		}
+	}
+}
+
 //Draw two overlapped animations to achieve the original effect
 //PlayOnce makes sure that if we stop drawing them, they will go away
 void Map::DrawPortal(const InfoPoint *ip, int enable)
@@ -641,6 +803,10 @@ void Map::UpdateScripts()
 
 	GenerateQueues();
 	SortQueues();
+	// catch any position changes that bypassed the movement code
+	for (Actor* actor : actors) {
+		UpdateActorIndex(actor);
+	}
 
 	// if masterarea, then we allow 'any' actors
 	// if not masterarea, we allow only players
@@ -654,6 +820,7 @@ void Map::UpdateScripts()
 	// also want to change the actor updating code below so it doesn't
 	// add new actions while we are trying to get rid of the area!)
 	if (!has_pcs && !(MasterArea && !actors.empty()) /*&& !CanFree()*/) {
+		DropStalePreloads();
 		return;
 	}
 
@@ -776,6 +943,7 @@ void Map::UpdateScripts()
 	}
 
 	//Check if we need to start some trap scripts
+	GatherRegionCandidates();
 	int ipCount = 0;
 	while (true) {
 		//For each InfoPoint in the map
@@ -798,10 +966,12 @@ void Map::UpdateScripts()
 			continue;
 		}
 
-		q = queue[PR_SCRIPT].size();
+		if (ip->Type == ST_TRAVEL) {
+			PreloadDestination(ip);
+		}
+
 		ieDword exitID = ip->GetGlobalID();
-		while (q--) {
-			Actor *actor = queue[PR_SCRIPT][q];
+		for (Actor* actor : regionCandidates[ipCount - 1]) {
 			if (ip->Type == ST_PROXIMITY) {
 				if (ip->Entered(actor)) {
 					// if trap triggered, then mark actor
@@ -832,6 +1002,7 @@ void Map::UpdateScripts()
 		ip->Update();
 	}
 
+	DropStalePreloads();
 	UpdateSpawns();
 	GenerateQueues();
 	SortQueues();
@@ -886,6 +1057,37 @@ void Map::BlockSearchMapFor(const Movable *actor) const
 	tileProps.BlockSearchMap(ConvertCoordToTile(actor->Pos), actor->circleSize, flag);
 }
 
+void Map::UpdateActorIndex(Actor *actor) const
+{
+	if (actorIndex.Move(actor, actor->Pos)) {
+		indexedCircleSize = std::max(indexedCircleSize, actor->circleSize);
+	}
+}
+
+void Map::RebuildActorIndex() const
+{
+	const Size& mapSize = PropsSize();
+	actorIndex.Reset(Size(mapSize.w * 16, mapSize.h * 12));
+	for (Actor* actor : actors) {
+		actorIndex.Insert(actor, actor->Pos);
+		indexedCircleSize = std::max(indexedCircleSize, actor->circleSize);
+	}
+}
+
+// the ranges are padded by the biggest circle, since most callers also check circle overlap
+Point Map::ActorCandidateMargin(int rangeX, int rangeY) const
+{
+	int circle = std::max(indexedCircleSize, 2);
+	return Point(rangeX + circle * 16, rangeY + circle * 12);
+}
+
+// returns the actors that could be within range of p, in the order of the actors vector
+std::vector<Actor*> Map::GetActorCandidates(const Point& p, int rangeX, int rangeY) const
+{
+	Point margin = ActorCandidateMargin(rangeX, rangeY);
+	return actorIndex.Query(p - margin, p + margin);
+}
+
 void Map::ClearSearchMapFor(const Movable *actor) const
 {
 	std::vector<Actor *> nearActors = GetAllActorsInRadius(actor->Pos, GA_NO_SELF|GA_NO_DEAD|GA_NO_LOS|GA_NO_UNSCHEDULED, MAX_CIRCLE_SIZE*3, actor);
@@ -1314,6 +1516,7 @@ VEFObject *Map::GetNextScriptedAnimation(const scaIterator &iter) const
 //Draw the game area (including overlays, actors, animations, weather)
 void Map::DrawMap(const Region& viewport, uint32_t dFlags)
 {
+	ProfileZone zone("DrawMap");
 	assert(TMap);
 	debugFlags = dFlags;
 
@@ -1368,8 +1571,7 @@ void Map::DrawMap(const Region& viewport, uint32_t dFlags)
 		TMap->DrawOverlays( viewport, rain, flags );
 	}
 
-	const auto& viewportWalls = WallsIntersectingRegion(viewport, false);
-	RedrawScreenStencil(viewport, viewportWalls.first);
+	RedrawScreenStencil(viewport);
 	video->SetStencilBuffer(wallStencil);
 	
 	//draw all background animations first
@@ -1683,6 +1885,20 @@ WallPolygonSet Map::WallsIntersectingRegion(Region r, bool includeDisabled, cons
 	return set;
 }
 
+const WallPolygonSet& Map::OccludingWalls(const void* object, const Region& bbox, const Point& pos)
+{
+	ObjectOcclusion& occlusion = objectStencils[object];
+	if (!occlusion.cached || occlusion.bbox != bbox || occlusion.pos != pos || occlusion.wallGeneration != wallGeneration) {
+		occlusion.cached = true;
+		occlusion.bbox = bbox;
+		occlusion.pos = pos;
+		occlusion.wallGeneration = wallGeneration;
+		occlusion.walls = WallsIntersectingRegion(bbox, false, &pos);
+		occlusion.stencilDrawn = false;
+	}
+	return occlusion.walls;
+}
+
 void Map::SetDrawingStencilForObject(const void* object, const Region& objectRgn, const WallPolygonSet& walls, const Point& viewPortOrigin)
 {
 	VideoBufferPtr stencil = nullptr;
@@ -1694,14 +1910,10 @@ void Map::SetDrawingStencilForObject(const void* object, const Region& objectRgn
 
 	if (behindWall && inFrontOfWall) {
 		// we need a custom stencil if both behind and in front of a wall
-		auto it = objectStencils.find(object);
-		if (it != objectStencils.end()) {
-			// we already made one
-			const auto& pair = it->second;
-			if (pair.second.RectInside(objectRgn)) {
-				// and it is still good
-				stencil = pair.first;
-			}
+		ObjectOcclusion& occlusion = objectStencils[object];
+		if (occlusion.stencil && occlusion.stencilRgn.RectInside(objectRgn)) {
+			// we already made one and it is still big enough
+			stencil = occlusion.stencil;
 		}
 		
 		if (stencil == nullptr) {
@@ -1711,15 +1923,18 @@ void Map::SetDrawingStencilForObject(const void* object, const Region& objectRgn
 			} else {
 				stencil = video->CreateBuffer(stencilRgn, Video::BufferFormat::DISPLAY_ALPHA);
 				DrawStencil(stencil, objectRgn, walls.first);
-				objectStencils[object] = std::make_pair(stencil, objectRgn);
+				occlusion.stencil = stencil;
+				occlusion.stencilRgn = objectRgn;
+				occlusion.stencilDrawn = true;
 			}
 		} else {
-			// TODO: we only need to do this because a door might have changed state over us
-			// if we could detect that we could avoid doing this expensive operation
-			// we could add another wall flag to mark doors and then we only need to do this if one of the "walls" over us has that flag set
-			stencil->Clear();
 			stencil->SetOrigin(objectRgn.origin - viewPortOrigin);
-			DrawStencil(stencil, objectRgn, walls.first);
+			// OccludingWalls marks it stale when the object or a door moved
+			if (!occlusion.stencilDrawn) {
+				stencil->Clear();
+				DrawStencil(stencil, objectRgn, walls.first);
+				occlusion.stencilDrawn = true;
+			}
 		}
 		
 		debugColor = ColorRed;
@@ -1757,7 +1972,7 @@ BlitFlags Map::SetDrawingStencilForScriptable(const Scriptable* scriptable, cons
 		return BlitFlags::NONE;
 	}
 	
-	WallPolygonSet walls = WallsIntersectingRegion(bbox, false, &scriptable->Pos);
+	const WallPolygonSet& walls = OccludingWalls(scriptable, bbox, scriptable->Pos);
 	SetDrawingStencilForObject(scriptable, bbox, walls, vp.origin);
 	
 	// check this after SetDrawingStencilForObject for debug drawing purposes
@@ -1804,7 +2019,7 @@ BlitFlags Map::SetDrawingStencilForAreaAnimation(const AreaAnimation* anim, cons
 	Point p = anim->Pos;
 	p.y += anim->height;
 
-	WallPolygonSet walls = WallsIntersectingRegion(bbox, false, &p);
+	const WallPolygonSet& walls = OccludingWalls(anim, bbox, p);
 	
 	SetDrawingStencilForObject(anim, bbox, walls, vp.origin);
 	
@@ -1932,14 +2147,58 @@ void Map::AddAnimation(AreaAnimation anim)
 	animations.insert(iter, std::move(anim));
 }
 
+void Map::PrefetchSounds() const
+{
+	std::vector<ResRef> sounds;
+	for (const Ambient* ambient : ambients) {
+		sounds.insert(sounds.end(), ambient->sounds.begin(), ambient->sounds.end());
+	}
+
+	// the combat sounds are the ones that can't wait
+	static const int combatSounds[] = { VB_ATTACK, VB_DAMAGE, VB_DIE, VB_HURT };
+	for (const Actor* actor : actors) {
+		for (int vc : combatSounds) {
+			ResRef sound;
+			actor->GetVerbalConstantSound(sound, vc);
+			if (sound.IsEmpty()) {
+				ieStrRef strref = actor->GetVerbalConstant(vc);
+				if (strref == ieStrRef::INVALID) continue;
+				sound = core->strings->GetStringBlock(strref).Sound;
+			}
+			if (!sound.IsEmpty()) {
+				sounds.push_back(sound);
+			}
+		}
+	}
+
+	std::sort(sounds.begin(), sounds.end());
+	sounds.erase(std::unique(sounds.begin(), sounds.end()), sounds.end());
+	core->GetAudioDrv()->Prefetch(sounds);
+}
+
 //reapplying all of the effects on the actors of this map
 //this might be unnecessary later
 void Map::UpdateEffects()
 {
+	ProfileZone zone("UpdateEffects");
+	size_t refreshed = 0;
 	size_t i = actors.size();
 	while (i--) {
+		// idle actors without effects keep their stats until something changes
+		if (!actors[i]->NeedsRefresh()) continue;
 		actors[i]->RefreshEffects();
+		++refreshed;
 	}
+
+	if (!LogEnabled(DEBUG, "Map")) return;
+
+	refreshedActors += refreshed;
+	if (++refreshTicks < 300) return;
+
+	Log(DEBUG, "Map", "{}: {:.1f} of {} actors refreshed per tick over the last {} ticks",
+		scriptName, refreshedActors / float(refreshTicks), actors.size(), refreshTicks);
+	refreshedActors = 0;
+	refreshTicks = 0;
 }
 
 void Map::Shout(const Actor* actor, int shoutID, bool global) const
@@ -2065,6 +2324,8 @@ void Map::AddActor(Actor* actor, bool init)
 	actor->Area = scriptName;
 	if (!HasActor(actor)) {
 		actors.push_back( actor );
+		actorIndex.Insert(actor, actor->Pos);
+		indexedCircleSize = std::max(indexedCircleSize, actor->circleSize);
 	}
 	if (init) {
 		actor->SetMap(this);
@@ -2111,6 +2372,7 @@ void Map::DeleteActor(int i)
 		}
 	}
 	//remove the actor from the area's actor list
+	actorIndex.Remove(actors[i]);
 	actors.erase( actors.begin()+i );
 }
 
@@ -2203,34 +2465,29 @@ Actor* Map::GetActorByGlobalID(ieDword objectID) const
 */
 Actor* Map::GetActor(const Point &p, int flags, const Movable *checker) const
 {
-	for (auto actor : actors) {
-		if (!actor->IsOver( p ))
-			continue;
-		if (!actor->ValidTarget(flags, checker) ) {
-			continue;
-		}
-		return actor;
-	}
-	return NULL;
+	// called for every node in FindPath, so this mustn't build a candidate list
+	Point margin = ActorCandidateMargin(0, 0);
+	return actorIndex.FindFirst(p - margin, p + margin, [&](const Actor* actor) {
+		return actor->IsOver(p) && actor->ValidTarget(flags, checker);
+	});
 }
 
 Actor* Map::GetActorInRadius(const Point &p, int flags, unsigned int radius) const
 {
-	for (auto actor : actors) {
-		if (PersonalDistance( p, actor ) > radius)
-			continue;
-		if (!actor->ValidTarget(flags) ) {
-			continue;
-		}
-		return actor;
-	}
-	return NULL;
+	// PersonalDistance subtracts 10 per circle size, which the candidate margin covers
+	int range = static_cast<int>(std::min(radius, 0xffffu));
+	Point margin = ActorCandidateMargin(range, range);
+	return actorIndex.FindFirst(p - margin, p + margin, [&](const Actor* actor) {
+		return PersonalDistance(p, actor) <= radius && actor->ValidTarget(flags);
+	});
 }
 
 std::vector<Actor *> Map::GetAllActorsInRadius(const Point &p, int flags, unsigned int radius, const Scriptable *see) const
 {
 	std::vector<Actor *> neighbours;
-	for (auto actor : actors) {
+	// radius is in feet, which are at most 16 pixels wide and 12 high
+	int range = static_cast<int>(std::min(radius, 0xffffu));
+	for (auto actor : GetActorCandidates(p, range * 16 + 1, range * 12 + 1)) {
 		if (!WithinRange(actor, p, radius)) {
 			continue;
 		}
@@ -2284,6 +2541,7 @@ void Map::JumpActors(bool jump) const
 			if (jump && !(actor->GetStat(IE_DONOTJUMP) & DNJ_BIRD)) {
 				ClearSearchMapFor(actor);
 				AdjustPositionNavmap(actor->Pos);
+				UpdateActorIndex(actor);
 				actor->ImpedeBumping();
 			}
 			actor->SetBase(IE_DONOTJUMP,0);
@@ -2353,6 +2611,7 @@ void Map::PurgeArea(bool items)
 		if (!actor->ValidTarget(GA_NO_DEAD|GA_NO_UNSCHEDULED|GA_NO_ALLY|GA_NO_ENEMY)) continue;
 		if (!actor->HomeLocation.IsZero() && !actor->HomeLocation.IsInvalid() && actor->Pos != actor->HomeLocation) {
 			actor->Pos = actor->HomeLocation;
+			UpdateActorIndex(actor);
 		}
 	}
 }
@@ -2473,8 +2732,8 @@ Actor *Map::GetActorByScriptName(const ieVariable& name) const
 std::vector<Actor*> Map::GetActorsInRect(const Region& rgn, int excludeFlags) const
 {
 	std::vector<Actor*> actorlist;
-	actorlist.reserve(actors.size());
-	for (auto actor : actors) {
+	const Point center = rgn.Center();
+	for (auto actor : GetActorCandidates(center, rgn.w - rgn.w / 2, rgn.h - rgn.h / 2)) {
 		if (!actor->ValidTarget(excludeFlags))
 			continue;
 		if (!rgn.PointInside(actor->Pos)
@@ -2645,18 +2904,16 @@ bool Map::IsWalkableTo(const Point &s, const Point &d, bool actorsAreBlocking, c
 	return bool(ret & mask);
 }
 
-void Map::RedrawScreenStencil(const Region& vp, const WallPolygonGroup& walls)
+void Map::RedrawScreenStencil(const Region& vp)
 {
-	// FIXME: how do we know if a door changed state?
-	// we need to redraw the stencil when that happens
-	// see TODO in Map::SetDrawingStencilForScriptable for another example of something that could use this
-
-	if (stencilViewport == vp) {
+	// doors toggling their walls bump wallGeneration
+	if (stencilViewport == vp && stencilGeneration == wallGeneration) {
 		assert(wallStencil);
 		return;
 	}
 
 	stencilViewport = vp;
+	stencilGeneration = wallGeneration;
 
 	if (wallStencil == NULL) {
 		// FIXME: this should be forced 8bit*4 color format
@@ -2668,7 +2925,8 @@ void Map::RedrawScreenStencil(const Region& vp, const WallPolygonGroup& walls)
 
 	wallStencil->Clear();
 
-	DrawStencil(wallStencil, vp, walls);
+	const auto& walls = WallsIntersectingRegion(vp, false);
+	DrawStencil(wallStencil, vp, walls.first);
 }
 
 void Map::DrawStencil(const VideoBufferPtr& stencilBuffer, const Region& vp, const WallPolygonGroup& walls) const
@@ -2902,6 +3160,7 @@ void Map::RemoveActor(Actor* actor)
 			ClearSearchMapFor(actor);
 			actor->SetMap(NULL);
 			actor->Area.Reset();
+			actorIndex.Remove(actor);
 			actors.erase( actors.begin()+i );
 			return;
 		}
@@ -3382,9 +3641,20 @@ void Map::ExploreTile(const Point &p, bool fogOnly)
 }
 
 void Map::ExploreMapChunk(const Point &Pos, int range, int los)
+{
+	VisibilityFootprint footprint;
+	TraceVisibility(Pos, range, los, footprint);
+	ApplyVisibility(footprint);
+}
+
+void Map::TraceVisibility(const Point& Pos, int range, int los, VisibilityFootprint& footprint) const
 {
 	Point Tile;
 	const Explore& explore = Explore::Get();
+	const Size fogSize = FogMapSize();
+
+	footprint.visible.clear();
+	footprint.exploredOnly.clear();
 
 	if (range > explore.MaxVisibility) {
 		range = explore.MaxVisibility;
@@ -3419,14 +3689,43 @@ void Map::ExploreMapChunk(const Point &Pos, int range, int los)
 					if (!Pass) break;
 				}
 			}
-			ExploreTile(Tile, fogOnly);
+
+			Point fogP = ConvertPointToFog(Tile);
+			if (!fogSize.PointInside(fogP)) {
+				continue;
+			}
+			int cell = fogP.y * fogSize.w + fogP.x;
+			if (fogOnly) {
+				footprint.exploredOnly.push_back(cell);
+			} else {
+				footprint.visible.push_back(cell);
+			}
 		}
 	}
+
+	// neighbouring rays mostly cross the same cells
+	for (auto cells : { &footprint.visible, &footprint.exploredOnly }) {
+		std::sort(cells->begin(), cells->end());
+		cells->erase(std::unique(cells->begin(), cells->end()), cells->end());
+	}
+}
+
+void Map::ApplyVisibility(const VisibilityFootprint& footprint)
+{
+	for (int cell : footprint.visible) {
+		ExploredBitmap[cell] = true;
+		VisibleBitmap[cell] = true;
+	}
+	for (int cell : footprint.exploredOnly) {
+		ExploredBitmap[cell] = true;
+	}
 }
 
 void Map::UpdateFog()
 {
+	ProfileZone zone("UpdateFog");
 	VisibleBitmap.fill(0);
+	++fogUpdates;
 	
 	std::set<Spawn*> potentialSpawns;
 	for (const auto actor : actors) {
@@ -3437,7 +3736,18 @@ void Map::UpdateFog()
 		
 		int vis2 = actor->Modified[IE_VISUALRANGE];
 		if ((state&STATE_BLIND) || (vis2<2)) vis2=2; //can see only themselves
-		ExploreMapChunk (actor->Pos, vis2+actor->GetAnims()->GetCircleSize(), 1);
+		int range = vis2 + actor->GetAnims()->GetCircleSize();
+
+		// only trace the rays again if anything they depend on changed
+		VisibilityFootprint& footprint = visibilityCache[actor->GetGlobalID()];
+		if (footprint.pos != actor->Pos || footprint.range != range || footprint.losGeneration != losGeneration) {
+			TraceVisibility(actor->Pos, range, 1, footprint);
+			footprint.pos = actor->Pos;
+			footprint.range = range;
+			footprint.losGeneration = losGeneration;
+		}
+		footprint.fogUpdate = fogUpdates;
+		ApplyVisibility(footprint);
 		
 		Spawn *sp = GetSpawnRadius(actor->Pos, SPAWN_RANGE); //30 * 12
 		if (sp) {
@@ -3448,6 +3758,15 @@ void Map::UpdateFog()
 	for (Spawn* spawn : potentialSpawns) {
 		TriggerSpawn(spawn);
 	}
+
+	// forget the explorers that left or stopped exploring
+	for (auto it = visibilityCache.begin(); it != visibilityCache.end();) {
+		if (it->second.fogUpdate != fogUpdates) {
+			it = visibilityCache.erase(it);
+		} else {
+			++it;
+		}
+	}
 }
 
 Spawn* Map::GetSpawn(const ieVariable& Name) const
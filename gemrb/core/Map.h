@@ -29,14 +29,13 @@
 #include "MapReverb.h"
 #include "Scriptable/Scriptable.h"
 #include "PathFinder.h"
+#include "SpatialIndex.h"
 #include "WorldMap.h"
 
 #include <algorithm>
 #include <queue>
 #include <unordered_map>
 
-template <class V> class FibonacciHeap;
-
 namespace GemRB {
 
 class Actor;
@@ -437,8 +436,71 @@ private:
 
 	VideoBufferPtr wallStencil = nullptr;
 	Region stencilViewport;
-
-	std::unordered_map<const void*, std::pair<VideoBufferPtr, Region>> objectStencils;
+	unsigned int stencilGeneration = 0;
+	// bumped whenever doors toggle their walls
+	unsigned int wallGeneration = 0;
+
+	// the walls covering a drawn object and its own stencil,
+	// only looked up again once the object or a door moves
+	struct ObjectOcclusion {
+		bool cached = false;
+		Region bbox;
+		Point pos;
+		unsigned int wallGeneration = 0;
+		WallPolygonSet walls;
+
+		VideoBufferPtr stencil = nullptr;
+		// the region the stencil buffer was created for
+		Region stencilRgn;
+		// whether the stencil contents still match walls and bbox
+		bool stencilDrawn = false;
+	};
+	std::unordered_map<const void*, ObjectOcclusion> objectStencils;
+	mutable PathFinderWorkspace pathWorkspace;
+	// grid of actor positions, so the proximity queries don't have to walk all actors
+	mutable SpatialIndex<Actor*> actorIndex;
+	// largest circle size seen while indexing, used as the query margin
+	mutable int indexedCircleSize = 0;
+
+	// the fog cells an explorer uncovers from its spot, so standing still is cheap
+	struct VisibilityFootprint {
+		Point pos;
+		int range = -1;
+		unsigned int losGeneration = 0;
+		unsigned int fogUpdate = 0;
+		// fog cell indices, already deduplicated
+		std::vector<int> visible;
+		std::vector<int> exploredOnly;
+	};
+	std::unordered_map<ieDword, VisibilityFootprint> visibilityCache;
+	// bumped whenever door or search map changes could alter the line of sight
+	unsigned int losGeneration = 0;
+	unsigned int fogUpdates = 0;
+	// actors refreshed by UpdateEffects, summed up for the debug log
+	size_t refreshedActors = 0;
+	size_t refreshTicks = 0;
+	// areas behind the travel regions the party came close to
+	struct Preload {
+		ResourcePreloader::Ticket ticket = ResourcePreloader::NoTicket;
+		// the party was still near one of its regions during the last update
+		bool inRange = false;
+	};
+	ResRefMap<Preload> preloads;
+
+	// proximity and travel regions (as infopoint indices) by the area they react to
+	RegionIndex<size_t> regionIndex;
+	size_t indexedRegions = 0;
+	unsigned int regionGeneration = 0;
+	// the regions a scripted actor was near, only looked up again once it moves
+	struct RegionReach {
+		Point pos;
+		int circleSize = -1;
+		unsigned int generation = 0;
+		std::vector<size_t> regions;
+	};
+	std::unordered_map<ieDword, RegionReach> actorRegions;
+	// per infopoint, the scripted actors that may be entering it this tick
+	std::vector<std::vector<Actor*>> regionCandidates;
 
 public:
 	Map(TileMap *tm, TileProps tileProps, Holder<Sprite2D> sm);
@@ -490,7 +552,10 @@ public:
 	void SetWallGroups(std::vector<WallPolygonGroup>&& walls)
 	{
 		wallGroups = std::move(walls);
+		InvalidateWalls();
 	}
+	/* drops the cached wall occlusion and stencils, call when walls got enabled or disabled */
+	void InvalidateWalls() { ++wallGeneration; }
 	bool BehindWall(const Point&, const Region&) const;
 	void Shout(const Actor* actor, int shoutID, bool global) const;
 	void ActorSpottedByPlayer(const Actor *actor) const;
@@ -520,6 +585,8 @@ public:
 	std::vector<Actor *> GetAllActorsInRadius(const Point &p, int flags, unsigned int radius, const Scriptable *see = NULL) const;
 	const std::vector<Actor *> &GetAllActors() const { return actors; }
 	std::vector<Actor*> GetActorsInRect(const Region& rgn, int excludeFlags) const;
+	/* actors that may be within the given pixel ranges of p, in actor list order; no other checks are done */
+	std::vector<Actor*> GetActorCandidates(const Point& p, int rangeX, int rangeY) const;
 	Actor* GetActor(const ieVariable& Name, int flags) const;
 	Actor* GetActor(int i, bool any) const;
 	Actor* GetActor(const Point &p, int flags, const Movable *checker = NULL) const;
@@ -587,10 +654,16 @@ public:
 	void ExploreTile(const Point&, bool fogOnly = false);
 	/* explore map from given point in map coordinates */
 	void ExploreMapChunk(const Point &Pos, int range, int los);
+	/* drops the cached actor visibility, call when the line of sight may have changed */
+	void InvalidateLOS() { ++losGeneration; }
 	void BlockSearchMapFor(const Movable *actor) const;
 	void ClearSearchMapFor(const Movable *actor) const;
+	/* keeps the actor proximity index in sync, call after moving an actor */
+	void UpdateActorIndex(Actor *actor) const;
 	/* update VisibleBitmap by resolving vision of all explore actors */
 	void UpdateFog();
+	/* lets the audio driver decode the ambients and combat sounds ahead of time */
+	void PrefetchSounds() const;
 	//PathFinder
 	/* Finds the nearest passable point */
 	void AdjustPosition(Point &goal, int radiusx = 0, int radiusy = 0, int size = -1) const;
@@ -673,9 +746,10 @@ private:
 	Actor *GetNextActor(int &q, size_t &index) const;
 	Container *GetNextPile (int &index) const;
 	
-	void RedrawScreenStencil(const Region& vp, const WallPolygonGroup& walls);
+	void RedrawScreenStencil(const Region& vp);
 	void DrawStencil(const VideoBufferPtr& stencilBuffer, const Region& vp, const WallPolygonGroup& walls) const;
 	WallPolygonSet WallsIntersectingRegion(Region, bool includeDisabled = false, const Point* loc = nullptr) const;
+	const WallPolygonSet& OccludingWalls(const void* object, const Region& bbox, const Point& pos);
 	
 	void SetDrawingStencilForObject(const void*, const Region&, const WallPolygonSet&, const Point& viewPortOrigin);
 	BlitFlags SetDrawingStencilForScriptable(const Scriptable*, const Region& viewPort);
@@ -688,6 +762,8 @@ private:
 	
 	Size PropsSize() const noexcept;
 	Size FogMapSize() const;
+	void TraceVisibility(const Point& pos, int range, int los, VisibilityFootprint& footprint) const;
+	void ApplyVisibility(const VisibilityFootprint& footprint);
 	bool FogTileUncovered(const Point &p, const Bitmap*) const;
 	Point ConvertPointToFog(const Point &p) const;
 	
@@ -697,11 +773,17 @@ private:
 	void DeleteActor(int i);
 	//actor uses travel region
 	void UseExit(Actor *pc, InfoPoint *ip);
+	void PreloadDestination(const InfoPoint *ip);
+	void DropStalePreloads();
+	void RebuildRegionIndex();
+	void GatherRegionCandidates();
 	//separated position adjustment, so their order could be randomised
 	bool AdjustPositionX(Point &goal, int radiusx, int radiusy, int size = -1) const;
 	bool AdjustPositionY(Point &goal, int radiusx, int radiusy, int size = -1) const;
 	
 	void UpdateSpawns() const;
+	void RebuildActorIndex() const;
+	Point ActorCandidateMargin(int rangeX, int rangeY) const;
 	PathMapFlags GetBlockedInLine(const Point &s, const Point &d, bool stopOnImpassable, const Actor *caller = NULL) const;
 	void AddProjectile(Projectile* pro);
 
@@ -28,6 +28,7 @@
 #define MAPMGR_H
 
 #include "Plugin.h"
+#include "ResourcePreloader.h"
 
 namespace GemRB {
 
@@ -42,6 +43,8 @@ class GEM_EXPORT MapMgr : public ImporterBase {
 public:
 	virtual bool ChangeMap(Map *map, bool day_or_night) = 0;
 	virtual Map* GetMap(const ResRef& ResRef, bool day_or_night) = 0;
+	/* starts reading the resources GetMap will need in the background */
+	virtual ResourcePreloader::Ticket PreloadResources(bool day_or_night, int priority) const = 0;
 
 	virtual int GetStoredFileSize(Map *map) = 0;
 	virtual int PutArea(DataStream* stream, const Map *map) const = 0;
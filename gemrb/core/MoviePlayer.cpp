@@ -20,11 +20,19 @@
 
 #include "MoviePlayer.h"
 
+#include "Audio.h"
 #include "GUI/Label.h"
 #include "Interface.h"
+#include "Palette.h"
 
 #include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstring>
+#include <deque>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 using namespace std::chrono;
 
@@ -32,6 +40,191 @@ namespace GemRB {
 
 const TypeID MoviePlayer::ID = { "MoviePlayer" };
 
+// records what a decoder wrote, so it can be replayed into the real buffer on the main thread
+class MovieFrame final : public VideoBuffer {
+	struct AudioChunk {
+		int stream;
+		unsigned short bits;
+		int channels;
+		std::vector<uint8_t> samples;
+		int samplerate;
+	};
+
+	Video::BufferFormat format;
+	Region dest;
+	std::vector<uint8_t> planes[3];
+	int pitches[3] {};
+	PaletteHolder palette;
+	bool hasPixels = false;
+	std::vector<AudioChunk> audio;
+
+	void CopyPlane(int plane, const void* pixels, const int* pitch, int bpp, int rows)
+	{
+		pitches[plane] = pitch ? *pitch : dest.w * bpp;
+		const uint8_t* src = static_cast<const uint8_t*>(pixels);
+		planes[plane].assign(src, src + pitches[plane] * rows);
+	}
+
+public:
+	size_t framePos = 0;
+	microseconds wait = microseconds(0);
+
+	MovieFrame(const Region& r, Video::BufferFormat fmt)
+	: VideoBuffer(r), format(fmt) {}
+
+	void Reset()
+	{
+		hasPixels = false;
+		audio.clear();
+	}
+
+	// the movie decoders draw the whole frame every time
+	void Clear(const Region&) override {}
+
+	void CopyPixels(const Region& bufDest, const void* pixelBuf, const int* pitch, ...) override
+	{
+		dest = bufDest;
+		hasPixels = true;
+
+		va_list args;
+		va_start(args, pitch);
+		switch (format) {
+			case Video::BufferFormat::YV12:
+				CopyPlane(0, pixelBuf, pitch, 1, dest.h);
+				for (int plane = 1; plane < 3; ++plane) {
+					const void* chroma = va_arg(args, const void*);
+					const int* chromaPitch = va_arg(args, const int*);
+					CopyPlane(plane, chroma, chromaPitch, 1, (dest.h + 1) / 2);
+				}
+				break;
+			case Video::BufferFormat::RGBPAL8:
+			case Video::BufferFormat::RGB555: {
+				CopyPlane(0, pixelBuf, pitch, format == Video::BufferFormat::RGB555 ? 2 : 1, dest.h);
+				// the palette changes between frames, so keep the one for this one
+				const Palette* pal = va_arg(args, const Palette*);
+				if (pal) {
+					palette = MakeHolder<Palette>(std::begin(pal->col), std::end(pal->col));
+				}
+				break;
+			}
+			default:
+				CopyPlane(0, pixelBuf, pitch, 4, dest.h);
+				break;
+		}
+		va_end(args);
+	}
+
+	bool RenderOnDisplay(void*) const override
+	{
+		return false;
+	}
+
+	void AddAudio(int stream, unsigned short bits, int channels, const short* memory, int size, int samplerate)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(memory);
+		audio.push_back({ stream, bits, channels, std::vector<uint8_t>(bytes, bytes + size), samplerate });
+	}
+
+	// audio has to be queued even for the frames that are skipped
+	void QueueAudio()
+	{
+		Audio* drv = core->GetAudioDrv();
+		for (AudioChunk& chunk : audio) {
+			drv->QueueBuffer(chunk.stream, chunk.bits, chunk.channels, reinterpret_cast<short*>(chunk.samples.data()),
+							 int(chunk.samples.size()), chunk.samplerate);
+		}
+		audio.clear();
+	}
+
+	void Present(VideoBuffer& target) const
+	{
+		if (!hasPixels) return;
+
+		if (format == Video::BufferFormat::YV12) {
+			target.CopyPixels(dest, planes[0].data(), &pitches[0], planes[1].data(), &pitches[1], planes[2].data(), &pitches[2]);
+		} else {
+			target.CopyPixels(dest, planes[0].data(), &pitches[0], palette.get());
+		}
+	}
+};
+
+// a small ring of frames going back and forth between the decoder thread and the main thread
+class MovieFrameQueue {
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::deque<MovieFrame*> free;
+	std::deque<MovieFrame*> ready;
+	std::vector<std::unique_ptr<MovieFrame>> frames;
+	bool finished = false; // the decoder is done
+	bool stopped = false; // the player is done
+
+public:
+	static const int Size = 4;
+
+	MovieFrameQueue(const Region& rect, Video::BufferFormat fmt)
+	{
+		for (int i = 0; i < Size; ++i) {
+			frames.emplace_back(new MovieFrame(rect, fmt));
+			free.push_back(frames.back().get());
+		}
+	}
+
+	// decoder side, returns nullptr once the player stopped
+	MovieFrame* AcquireFree()
+	{
+		std::unique_lock<std::mutex> l(mutex);
+		cond.wait(l, [this]() { return !free.empty() || stopped; });
+		if (stopped) return nullptr;
+
+		MovieFrame* frame = free.front();
+		free.pop_front();
+		return frame;
+	}
+
+	void PushReady(MovieFrame* frame)
+	{
+		std::lock_guard<std::mutex> l(mutex);
+		ready.push_back(frame);
+		cond.notify_all();
+	}
+
+	void Finish()
+	{
+		std::lock_guard<std::mutex> l(mutex);
+		finished = true;
+		cond.notify_all();
+	}
+
+	// player side, returns nullptr once the decoder has nothing more to give
+	MovieFrame* AcquireReady(bool wait = true)
+	{
+		std::unique_lock<std::mutex> l(mutex);
+		if (wait) {
+			cond.wait(l, [this]() { return !ready.empty() || finished; });
+		}
+		if (ready.empty()) return nullptr;
+
+		MovieFrame* frame = ready.front();
+		ready.pop_front();
+		return frame;
+	}
+
+	void Release(MovieFrame* frame)
+	{
+		frame->Reset();
+		std::lock_guard<std::mutex> l(mutex);
+		free.push_back(frame);
+		cond.notify_all();
+	}
+
+	void Stop()
+	{
+		std::lock_guard<std::mutex> l(mutex);
+		stopped = true;
+		cond.notify_all();
+	}
+};
+
 MoviePlayer::~MoviePlayer(void)
 {
 	Stop();
@@ -54,6 +247,37 @@ bool MoviePlayer::SubtitlesEnabled() const
 	return showSubtitles && subtitles;
 }
 
+void MoviePlayer::QueueAudio(int stream, unsigned short bits, int channels, const short* memory, int size, int samplerate) const
+{
+	if (stream < 0) return;
+
+	if (decodingFrame) {
+		decodingFrame->AddAudio(stream, bits, channels, memory, size, samplerate);
+	} else {
+		// initialization chunks, before playback started
+		core->GetAudioDrv()->QueueBuffer(stream, bits, channels, const_cast<short*>(memory), size, samplerate);
+	}
+}
+
+void MoviePlayer::DecodeAhead(MovieFrameQueue& queue)
+{
+	while (MovieFrame* frame = queue.AcquireFree()) {
+		decodingFrame = frame;
+		bool decoded = DecodeFrame(*frame);
+		decodingFrame = nullptr;
+		if (!decoded) {
+			// error / end
+			queue.Release(frame);
+			break;
+		}
+
+		frame->framePos = framePos;
+		frame->wait = frame_wait;
+		queue.PushReady(frame);
+	}
+	queue.Finish();
+}
+
 void MoviePlayer::Play(Window* win)
 {
 	assert(win);
@@ -79,10 +303,15 @@ void MoviePlayer::Play(Window* win)
 		subBuf = video->CreateBuffer(subFrame, Video::BufferFormat::DISPLAY_ALPHA);
 	}
 
+	// the decoding happens ahead on its own thread, so a slow frame doesn't stall the presentation
+	MovieFrameQueue queue(Region(Point(), size), movieFormat);
+	std::thread decoder(&MoviePlayer::DecodeAhead, this, std::ref(queue));
+
 	// currently, our MoviePlayer implementation takes over the entire screen
 	// not only that but the Play method blocks until movie is done/stopped.
 	win->Focus(); // we bypass the WindowManager for drawing, but for event handling we need this
 	isPlaying = true;
+	lastTime = microseconds(0);
 	do {
 		// taking over the application runloop...
 		
@@ -92,21 +321,47 @@ void MoviePlayer::Play(Window* win)
 		
 		// first draw the window for play controls/subtitles
 		//win->Draw();
-		
-		video->PushDrawingBuffer(vb);
-		if (DecodeFrame(*vb) == false) {
+
+		MovieFrame* frame = queue.AcquireReady();
+		if (!frame) {
 			Stop(); // error / end
+			break;
+		}
+		if (lastTime > microseconds(0)) {
+			timer_wait(frame->wait);
+		} else {
+			timer_start();
+		}
+
+		// drop frames we are late for, as long as the next one is already there
+		while (video_frameskip) {
+			MovieFrame* next = queue.AcquireReady(false);
+			if (!next) break;
+			frame->QueueAudio();
+			queue.Release(frame);
+			frame = next;
+			video_frameskip--;
+			video_skippedframes++;
 		}
+		video_frameskip = 0;
+
+		frame->QueueAudio();
+		video->PushDrawingBuffer(vb);
+		frame->Present(*vb);
 		
 		if (subtitles && showSubtitles) {
 			assert(subBuf);
 			// we purposely draw on the window, which may be larger than the video
 			video->PushDrawingBuffer(subBuf);
-			subtitles->RenderInBuffer(*subBuf, framePos);
+			subtitles->RenderInBuffer(*subBuf, frame->framePos);
 		}
+		queue.Release(frame);
 		// TODO: pass movie fps (and remove the cap from within the movie decoders)
 	} while ((video->SwapBuffers(0) == GEM_OK) && isPlaying);
 
+	queue.Stop();
+	decoder.join();
+
 	delete win->View::RemoveSubview(mpc);
 }
 
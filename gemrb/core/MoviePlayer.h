@@ -41,6 +41,8 @@
 
 namespace GemRB {
 
+class MovieFrame;
+
 /**
  * @class MoviePlayer
  * Abstract loader and player for videos
@@ -81,6 +83,10 @@ private:
 	bool isPlaying = false;
 	bool showSubtitles = false;
 	SubtitleSet* subtitles = nullptr;
+	// the frame the decoder thread is filling, it also collects the audio to go with it
+	MovieFrame* decodingFrame = nullptr;
+
+	void DecodeAhead(class MovieFrameQueue& queue);
 
 protected:
 	// NOTE: make sure any new movie plugins set these!
@@ -90,6 +96,7 @@ protected:
 
 	microseconds lastTime = microseconds(0);
 
+	// time between frames, the decoders may change it at any time
 	microseconds frame_wait = microseconds(0);
 	unsigned int video_frameskip = 0;
 	unsigned int video_skippedframes = 0;
@@ -102,7 +109,10 @@ protected:
 	void timer_start();
 	void timer_wait(microseconds frameWait);
 
+	// runs on a separate thread, a few frames ahead of their presentation
 	virtual bool DecodeFrame(VideoBuffer&) = 0;
+	// for the audio belonging to the frame being decoded, so it's queued only once the frame is shown
+	void QueueAudio(int stream, unsigned short bits, int channels, const short* memory, int size, int samplerate) const;
 
 public:
 	MoviePlayer() noexcept {};
@@ -34,15 +34,14 @@
 // Moving to each node in the path thus becomes an automatic regulation problem
 // which is solved with a P regulator, see Scriptable.cpp
 
-#include "FibonacciHeap.h"
 #include "GameData.h"
 #include "Map.h"
 #include "PathFinder.h"
+#include "Profiler.h"
 #include "RNG.h"
 #include "Scriptable/Actor.h"
 
 #include <array>
-#include <limits>
 
 namespace GemRB {
 
@@ -300,7 +299,10 @@ PathListNode *Map::GetLine(const Point &p, int steps, orient_t orient) const
 // target (the goal must be in sight of the end, if PF_SIGHT is specified)
 PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, unsigned int minDistance, int flags, const Actor *caller) const
 {
-	Log(DEBUG, "FindPath", "s = {}, d = {}, caller = {}, dist = {}, size = {}", s, d, caller ? MBStringFromString(caller->GetShortName()) : "nullptr", minDistance, size);
+	ProfileZone zone("FindPath");
+	if (LogEnabled(DEBUG, "FindPath")) {
+		Log(DEBUG, "FindPath", "s = {}, d = {}, caller = {}, dist = {}, size = {}", s, d, caller ? MBStringFromString(caller->GetShortName()) : "nullptr", minDistance, size);
+	}
 	NavmapPoint nmptDest = d;
 	NavmapPoint nmptSource = s;
 	if (!(GetBlockedInRadius(d, size) & PathMapFlags::PASSABLE)) {
@@ -311,7 +313,9 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 		AdjustPositionNavmap(nmptDest);
 	}
 	if (minDistance < size && !(GetBlockedInRadius(nmptDest, size) & (PathMapFlags::PASSABLE | PathMapFlags::ACTOR))) {
-		Log(DEBUG, "FindPath", "{} can't fit in destination", caller ? MBStringFromString(caller->GetShortName()) : "nullptr");
+		if (LogEnabled(DEBUG, "FindPath")) {
+			Log(DEBUG, "FindPath", "{} can't fit in destination", caller ? MBStringFromString(caller->GetShortName()) : "nullptr");
+		}
 		return nullptr;
 	}
 	SearchmapPoint smptSource(nmptSource.x / 16, nmptSource.y / 12);
@@ -322,21 +326,16 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 	if (!mapSize.PointInside(smptSource)) return nullptr;
 
 	// Initialize data structures
-	FibonacciHeap<PQNode> open;
-	std::vector<bool> isClosed(mapSize.Area(), false);
-	std::vector<NavmapPoint> parents(mapSize.Area(), Point(0, 0));
-	std::vector<unsigned short> distFromStart(mapSize.Area(), std::numeric_limits<unsigned short>::max());
-	distFromStart[smptSource.y * mapSize.w + smptSource.x] = 0;
-	parents[smptSource.y * mapSize.w + smptSource.x] = nmptSource;
-	open.emplace(PQNode(nmptSource, 0));
+	pathWorkspace.Reset(mapSize.Area());
+	pathWorkspace.SetParent(smptSource.y * mapSize.w + smptSource.x, nmptSource, 0);
+	pathWorkspace.PushOpen(PQNode(nmptSource, 0));
 	bool foundPath = false;
 	unsigned int squaredMinDist = minDistance * minDistance;
 
-	while (!open.empty()) {
-		NavmapPoint nmptCurrent = open.top().point;
-		open.pop();
+	while (!pathWorkspace.OpenEmpty()) {
+		NavmapPoint nmptCurrent = pathWorkspace.PopOpen().point;
 		SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
-		if (parents[smptCurrent.y * mapSize.w + smptCurrent.x] == Point(0, 0)) {
+		if (pathWorkspace.GetParent(smptCurrent.y * mapSize.w + smptCurrent.x) == Point(0, 0)) {
 			continue;
 		}
 
@@ -345,7 +344,7 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 			foundPath = true;
 			break;
 		} else if (minDistance) {
-			if (parents[smptCurrent.y * mapSize.w + smptCurrent.x] != nmptCurrent &&
+			if (pathWorkspace.GetParent(smptCurrent.y * mapSize.w + smptCurrent.x) != nmptCurrent &&
 					SquaredDistance(nmptCurrent, nmptDest) < squaredMinDist) {
 				if (!(flags & PF_SIGHT) || IsVisibleLOS(nmptCurrent, d)) {
 					smptDest = smptCurrent;
@@ -355,7 +354,7 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 				}
 			}
 		}
-		isClosed[smptCurrent.y * mapSize.w + smptCurrent.x] = true;
+		pathWorkspace.Close(smptCurrent.y * mapSize.w + smptCurrent.x);
 
 		for (size_t i = 0; i < DEGREES_OF_FREEDOM; i++) {
 			NavmapPoint nmptChild(nmptCurrent.x + 16 * dxAdjacent[i], nmptCurrent.y + 12 * dyAdjacent[i]);
@@ -363,7 +362,8 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 			// Outside map
 			if (smptChild.x < 0 ||	smptChild.y < 0 || smptChild.x >= mapSize.w || smptChild.y >= mapSize.h) continue;
 			// Already visited
-			if (isClosed[smptChild.y * mapSize.w + smptChild.x]) continue;
+			size_t childIdx = smptChild.y * mapSize.w + smptChild.x;
+			if (pathWorkspace.IsClosed(childIdx)) continue;
 			// If there's an actor, check it can be bumped away
 			const Actor* childActor = GetActor(nmptChild, GA_NO_DEAD | GA_NO_UNSCHEDULED);
 			bool childIsUnbumpable = childActor && childActor != caller && (flags & PF_ACTORS_ARE_BLOCKING || !childActor->ValidTarget(GA_ONLY_BUMPABLE));
@@ -376,26 +376,27 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 			// Weighted heuristic. Finds sub-optimal paths but should be quite a bit faster
 			const float HEURISTIC_WEIGHT = 1.5;
 			SearchmapPoint smptCurrent2(nmptCurrent.x / 16, nmptCurrent.y / 12);
-			NavmapPoint nmptParent = parents[smptCurrent2.y * mapSize.w + smptCurrent2.x];
-			unsigned short oldDist = distFromStart[smptChild.y * mapSize.w + smptChild.x];
+			NavmapPoint nmptParent = pathWorkspace.GetParent(smptCurrent2.y * mapSize.w + smptCurrent2.x);
+			unsigned short oldDist = pathWorkspace.GetDistance(childIdx);
+			unsigned short childDist = oldDist;
 			// Theta-star path if there is LOS
 			if (IsWalkableTo(nmptParent, nmptChild, flags & PF_ACTORS_ARE_BLOCKING, caller)) {
 				SearchmapPoint smptParent(nmptParent.x / 16, nmptParent.y / 12);
-				unsigned short newDist = distFromStart[smptParent.y * mapSize.w + smptParent.x] + Distance(smptParent, smptChild);
+				unsigned short newDist = pathWorkspace.GetDistance(smptParent.y * mapSize.w + smptParent.x) + Distance(smptParent, smptChild);
 				if (newDist < oldDist) {
-					parents[smptChild.y * mapSize.w + smptChild.x] = nmptParent;
-					distFromStart[smptChild.y * mapSize.w + smptChild.x] = newDist;
+					pathWorkspace.SetParent(childIdx, nmptParent, newDist);
+					childDist = newDist;
 				}
 			// Fall back to A-star path
 			} else if (IsWalkableTo(nmptCurrent, nmptChild, flags & PF_ACTORS_ARE_BLOCKING, caller)) {
-				unsigned short newDist = distFromStart[smptCurrent2.y * mapSize.w + smptCurrent2.x] + Distance(smptCurrent2, smptChild);
+				unsigned short newDist = pathWorkspace.GetDistance(smptCurrent2.y * mapSize.w + smptCurrent2.x) + Distance(smptCurrent2, smptChild);
 				if (newDist < oldDist) {
-					parents[smptChild.y * mapSize.w + smptChild.x] = nmptCurrent;
-					distFromStart[smptChild.y * mapSize.w + smptChild.x] = newDist;
+					pathWorkspace.SetParent(childIdx, nmptCurrent, newDist);
+					childDist = newDist;
 				}
 			}
 
-			if (distFromStart[smptChild.y * mapSize.w + smptChild.x] < oldDist) {
+			if (childDist < oldDist) {
 				// Calculate heuristic
 				int xDist = smptChild.x - smptDest.x;
 				int yDist = smptChild.y - smptDest.y;
@@ -405,9 +406,8 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 				int crossProduct = std::abs(xDist * dyCross - yDist * dxCross) >> 3;
 				double distance = std::hypot(xDist, yDist);
 				double heuristic = HEURISTIC_WEIGHT * (distance + crossProduct);
-				double estDist = distFromStart[smptChild.y * mapSize.w + smptChild.x] + heuristic;
-				PQNode newNode(nmptChild, estDist);
-				open.emplace(newNode);
+				double estDist = childDist + heuristic;
+				pathWorkspace.PushOpen(PQNode(nmptChild, estDist));
 			}
 		}
 	}
@@ -417,8 +417,8 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 		NavmapPoint nmptCurrent = nmptDest;
 		NavmapPoint nmptParent;
 		SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
-		while (!resultPath || nmptCurrent != parents[smptCurrent.y * mapSize.w + smptCurrent.x]) {
-			nmptParent = parents[smptCurrent.y * mapSize.w + smptCurrent.x];
+		while (!resultPath || nmptCurrent != pathWorkspace.GetParent(smptCurrent.y * mapSize.w + smptCurrent.x)) {
+			nmptParent = pathWorkspace.GetParent(smptCurrent.y * mapSize.w + smptCurrent.x);
 			PathListNode *newStep = new PathListNode;
 			newStep->point = nmptCurrent;
 			newStep->Next = resultPath;
@@ -447,6 +447,62 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 	return nullptr;
 }
 
+void PathFinderWorkspace::Reset(size_t area)
+{
+	if (cells.size() != area) {
+		cells.assign(area, Cell());
+		generation = 0;
+	}
+	open.clear();
+
+	++generation;
+	if (generation == 0) {
+		// wrapped around, so old stamps could become valid again
+		for (Cell& cell : cells) {
+			cell.stamp = 0;
+		}
+		generation = 1;
+	}
+}
+
+void PathFinderWorkspace::PushOpen(const PQNode& node)
+{
+	size_t pos = open.size();
+	open.push_back(node);
+	while (pos > 0) {
+		size_t parent = (pos - 1) / 4;
+		if (!(node < open[parent])) break;
+		open[pos] = open[parent];
+		pos = parent;
+	}
+	open[pos] = node;
+}
+
+PQNode PathFinderWorkspace::PopOpen()
+{
+	PQNode top = open.front();
+	PQNode last = open.back();
+	open.pop_back();
+	size_t size = open.size();
+	if (size == 0) return top;
+
+	size_t pos = 0;
+	while (true) {
+		size_t first = 4 * pos + 1;
+		if (first >= size) break;
+		size_t best = first;
+		size_t end = std::min(first + 4, size);
+		for (size_t child = first + 1; child < end; ++child) {
+			if (open[child] < open[best]) best = child;
+		}
+		if (!(open[best] < last)) break;
+		open[pos] = open[best];
+		pos = best;
+	}
+	open[pos] = last;
+	return top;
+}
+
 void Map::NormalizeDeltas(double &dx, double &dy, const double &factor)
 {
 	const double STEP_RADIUS = 2.0;
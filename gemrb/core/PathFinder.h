@@ -101,6 +101,60 @@ public:
 
 };
 
+// Scratch space for Map::FindPath, owned by each map and reused between searches,
+// so we don't allocate and clear several searchmap sized buffers per call.
+// A cell only holds valid data if its stamp matches the current search generation,
+// so starting a new search is O(1).
+class PathFinderWorkspace {
+public:
+	// prepares the workspace for a new search over a map with area cells
+	void Reset(size_t area);
+
+	bool IsClosed(size_t idx) const { return IsFresh(idx) && cells[idx].closed; }
+	NavmapPoint GetParent(size_t idx) const { return IsFresh(idx) ? cells[idx].parent : NavmapPoint(0, 0); }
+	unsigned short GetDistance(size_t idx) const { return IsFresh(idx) ? cells[idx].dist : UNVISITED; }
+
+	void Close(size_t idx) { Touch(idx).closed = true; }
+	void SetParent(size_t idx, const NavmapPoint& parent, unsigned short dist)
+	{
+		Cell& cell = Touch(idx);
+		cell.parent = parent;
+		cell.dist = dist;
+	}
+
+	// open list, a 4-ary min heap on the estimated distance
+	bool OpenEmpty() const { return open.empty(); }
+	void PushOpen(const PQNode& node);
+	PQNode PopOpen();
+
+private:
+	static constexpr unsigned short UNVISITED = 0xffff;
+
+	struct Cell {
+		uint32_t stamp = 0;
+		unsigned short dist = UNVISITED;
+		bool closed = false;
+		NavmapPoint parent;
+	};
+
+	bool IsFresh(size_t idx) const { return cells[idx].stamp == generation; }
+	Cell& Touch(size_t idx)
+	{
+		Cell& cell = cells[idx];
+		if (cell.stamp != generation) {
+			cell.stamp = generation;
+			cell.dist = UNVISITED;
+			cell.closed = false;
+			cell.parent = NavmapPoint(0, 0);
+		}
+		return cell;
+	}
+
+	std::vector<Cell> cells;
+	std::vector<PQNode> open;
+	uint32_t generation = 0;
+};
+
 }
 
 #endif
@@ -0,0 +1,151 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "Profiler.h"
+
+#include "Logging/Logging.h"
+#include "Streams/FileStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace GemRB {
+
+struct ProfileEvent {
+	const char* name;
+	char detail[32];
+	Profiler::Clock::time_point start;
+	Profiler::Clock::duration length;
+	int thread;
+};
+
+static std::mutex mutex;
+static std::vector<ProfileEvent> ring; // allocated on first use, so nothing is paid unless profiling
+static size_t next = 0;
+static bool wrapped = false;
+static Profiler::Clock::time_point epoch;
+static std::atomic<int> threadCount { 0 };
+
+static int ThreadNumber()
+{
+	static thread_local int number = ++threadCount;
+	return number;
+}
+
+static void AppendEscaped(std::string& out, const char* str)
+{
+	for (; *str; ++str) {
+		unsigned char c = *str;
+		if (c == '"' || c == '\\') {
+			out += '\\';
+			out += char(c);
+		} else if (c < 0x20) {
+			out += fmt::format("\\u{:04x}", c);
+		} else {
+			out += char(c);
+		}
+	}
+}
+
+std::atomic<bool> Profiler::enabled { false };
+
+void Profiler::SetEnabled(bool enable)
+{
+	if (enable) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (ring.empty()) {
+			ring.resize(Capacity);
+			epoch = Clock::now();
+		}
+	}
+	enabled = enable;
+	Log(MESSAGE, "Profiler", "Profiling {}.", enable ? "started" : "stopped");
+}
+
+void Profiler::Clear()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	next = 0;
+	wrapped = false;
+}
+
+void Profiler::Record(const char* name, StringView detail, Clock::time_point start, Clock::time_point end)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (ring.empty()) return;
+
+	ProfileEvent& event = ring[next];
+	event.name = name;
+	size_t len = std::min(detail.length(), sizeof(event.detail) - 1);
+	if (len) {
+		memcpy(event.detail, detail.c_str(), len);
+	}
+	event.detail[len] = '\0';
+	event.start = start;
+	event.length = end - start;
+	event.thread = ThreadNumber();
+
+	if (++next == ring.size()) {
+		next = 0;
+		wrapped = true;
+	}
+}
+
+bool Profiler::Dump(const char* path)
+{
+	using us = std::chrono::duration<double, std::micro>;
+
+	std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	size_t count = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		count = wrapped ? ring.size() : next;
+		// oldest first
+		size_t first = wrapped ? next : 0;
+		for (size_t i = 0; i < count; ++i) {
+			const ProfileEvent& event = ring[(first + i) % ring.size()];
+			if (i) out += ",\n";
+			out += "{\"name\":\"";
+			AppendEscaped(out, event.name);
+			out += fmt::format("\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}",
+							   event.thread, us(event.start - epoch).count(), us(event.length).count());
+			if (event.detail[0]) {
+				out += ",\"args\":{\"detail\":\"";
+				AppendEscaped(out, event.detail);
+				out += "\"}";
+			}
+			out += "}";
+		}
+	}
+	out += "\n]}\n";
+
+	FileStream file;
+	if (!file.Create(path) || file.Write(out.c_str(), out.length()) != strret_t(out.length())) {
+		Log(ERROR, "Profiler", "Unable to write the trace to '{}'!", path);
+		return false;
+	}
+	Log(MESSAGE, "Profiler", "Wrote {} zones to '{}'.", count, path);
+	return true;
+}
+
+}
@@ -0,0 +1,90 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "exports.h"
+
+#include "Strings/StringView.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace GemRB {
+
+/**
+ * @class Profiler
+ * Records timed zones into a ring buffer, which keeps the last few hundred
+ * frames worth of them, and writes them out in the Chrome trace event format
+ * (load them in chrome://tracing, Perfetto or Speedscope).
+ * When disabled, a zone only costs checking a flag.
+ */
+class GEM_EXPORT Profiler {
+public:
+	using Clock = std::chrono::steady_clock;
+	static const size_t Capacity = 1 << 16;
+
+	static bool IsEnabled() noexcept { return enabled.load(std::memory_order_relaxed); }
+	/** Starts or stops recording, the already recorded zones are kept */
+	static void SetEnabled(bool);
+	/** Forgets everything recorded so far */
+	static void Clear();
+	static void Record(const char* name, StringView detail, Clock::time_point start, Clock::time_point end);
+	/** Writes the recorded zones as a Chrome trace to the file */
+	static bool Dump(const char* path);
+
+private:
+	static std::atomic<bool> enabled;
+};
+
+/**
+ * @class ProfileZone
+ * Times its own lifetime. The name has to be a string literal or otherwise
+ * outlive the profiler, the optional detail (a resref, a function name) is copied.
+ */
+class ProfileZone {
+	const char* name = nullptr; // only set if the profiler was on when entering the zone
+	StringView detail;
+	Profiler::Clock::time_point start;
+
+public:
+	explicit ProfileZone(const char* zoneName, StringView zoneDetail = StringView()) noexcept
+	{
+		if (Profiler::IsEnabled()) {
+			name = zoneName;
+			detail = zoneDetail;
+			start = Profiler::Clock::now();
+		}
+	}
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+	~ProfileZone()
+	{
+		if (name) {
+			Profiler::Record(name, detail, start, Profiler::Clock::now());
+		}
+	}
+};
+
+}
+
+#endif
@@ -22,6 +22,7 @@
 
 #include "Interface.h"
 #include "PluginMgr.h"
+#include "Profiler.h"
 #include "Resource.h"
 #include "ResourceDesc.h"
 
@@ -98,6 +99,14 @@ DataStream* ResourceManager::GetResource(StringView ResRef, SClass_ID type, bool
 {
 	if (ResRef.empty())
 		return nullptr;
+	ProfileZone zone("GetResource", ResRef);
+	DataStream* preloaded = preloader.Take(ResRef, core->TypeExt(type));
+	if (preloaded) {
+		if (!silent) {
+			Log(MESSAGE, "ResourceManager", "Found '{}.{}' preloaded.", ResRef, core->TypeExt(type));
+		}
+		return preloaded;
+	}
 	for (const auto& path : searchPath) {
 		DataStream *ds = path->GetResource(ResRef, type);
 		if (ds) {
@@ -117,11 +126,22 @@ Resource* ResourceManager::GetResource(StringView ResRef, const TypeID *type, bo
 {
 	if (ResRef.empty())
 		return nullptr;
+	ProfileZone zone("GetResource", ResRef);
 	if (!silent) {
 		Log(MESSAGE, "ResourceManager", "Searching for '{}'...", ResRef);
 	}
 	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
 	for (const auto& type2 : types) {
+		DataStream* preloaded = preloader.Take(ResRef, type2.GetExt());
+		if (preloaded) {
+			Resource* res = type2.Create(preloaded);
+			if (res) {
+				if (!silent) {
+					Log(MESSAGE, "ResourceManager", "Found '{}.{}' preloaded.", ResRef, type2.GetExt());
+				}
+				return res;
+			}
+		}
 		for (const auto& path : searchPath) {
 			DataStream *str = path->GetResource(ResRef, type2);
 			if (!str && useCorrupt && core->UseCorruptedHack) {
@@ -150,4 +170,51 @@ Resource* ResourceManager::GetResource(StringView ResRef, const TypeID *type, bo
 	return NULL;
 }
 
+ResourcePreloader::Ticket ResourceManager::Preload(ResourcePreloader::Ticket ticket, const ResRef& resname, SClass_ID type, int priority)
+{
+	const char* ext = core->TypeExt(type);
+	if (resname.IsEmpty() || preloader.Has(resname, ext)) {
+		return ticket;
+	}
+	// only the lookup happens here, the sources aren't meant to be used from several threads
+	for (const auto& path : searchPath) {
+		DataStream* str = path->GetResource(resname, type);
+		if (str) {
+			return preloader.Add(ticket, resname, ext, str, priority);
+		}
+	}
+	return ticket;
+}
+
+ResourcePreloader::Ticket ResourceManager::Preload(ResourcePreloader::Ticket ticket, const ResRef& resname, const TypeID *type, int priority)
+{
+	if (resname.IsEmpty()) {
+		return ticket;
+	}
+	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
+	for (const auto& type2 : types) {
+		if (preloader.Has(resname, type2.GetExt())) {
+			return ticket;
+		}
+		for (const auto& path : searchPath) {
+			DataStream* str = path->GetResource(resname, type2);
+			core->UseCorruptedHack = false;
+			if (str) {
+				return preloader.Add(ticket, resname, type2.GetExt(), str, priority);
+			}
+		}
+	}
+	return ticket;
+}
+
+void ResourceManager::CancelPreload(ResourcePreloader::Ticket ticket)
+{
+	preloader.Cancel(ticket);
+}
+
+bool ResourceManager::PreloadPending(ResourcePreloader::Ticket ticket) const
+{
+	return preloader.Pending(ticket);
+}
+
 }
@@ -25,6 +25,7 @@
 
 #include "Holder.h"
 #include "Resource.h"
+#include "ResourcePreloader.h"
 #include "ResourceSource.h"
 
 #include <vector>
@@ -57,8 +58,23 @@ public:
 	/** Returns Resource object associated to given resource */
 	Resource* GetResource(StringView resname, const TypeID *type, bool silent = false, bool useCorrupt = false) const;
 
+	/**
+	 * Read the resource into memory in the background, GetResource picks it up from there.
+	 * @param[in] ticket Batch to add it to, NoTicket starts a new one.
+	 * @param[in] priority Batches with a higher priority are read first.
+	 * @return The ticket of the batch, which can be used to cancel it.
+	 **/
+	ResourcePreloader::Ticket Preload(ResourcePreloader::Ticket ticket, const ResRef& resname, SClass_ID type, int priority);
+	/** Same as above, for the first of the types that exists */
+	ResourcePreloader::Ticket Preload(ResourcePreloader::Ticket ticket, const ResRef& resname, const TypeID *type, int priority);
+	/** Drop what was preloaded for the ticket and not used yet */
+	void CancelPreload(ResourcePreloader::Ticket ticket);
+	/** Whether some of what was preloaded for the ticket wasn't used yet */
+	bool PreloadPending(ResourcePreloader::Ticket ticket) const;
+
 private:
 	std::vector<std::shared_ptr<ResourceSource> > searchPath;
+	mutable ResourcePreloader preloader;
 };
 
 }
@@ -0,0 +1,205 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "ResourcePreloader.h"
+
+#include "Logging/Logging.h"
+#include "Streams/MemoryStream.h"
+#include "Strings/CString.h"
+
+namespace GemRB {
+
+ResourcePreloader::~ResourcePreloader()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	cv.notify_all();
+	if (worker.joinable()) {
+		worker.join();
+	}
+
+	while (!entries.empty()) {
+		Discard(entries.begin());
+	}
+}
+
+std::list<ResourcePreloader::Entry>::iterator ResourcePreloader::Find(const ResRef& name, const char* ext)
+{
+	for (auto it = entries.begin(); it != entries.end(); ++it) {
+		if (!it->cancelled && it->name == name && stricmp(it->ext.c_str(), ext) == 0) {
+			return it;
+		}
+	}
+	return entries.end();
+}
+
+// expects the lock to be held and the entry not to be in the hands of the worker
+void ResourcePreloader::Discard(std::list<Entry>::iterator it)
+{
+	delete it->stream;
+	free(it->data);
+	bytes -= it->size;
+	entries.erase(it);
+}
+
+ResourcePreloader::Ticket ResourcePreloader::Add(Ticket ticket, const ResRef& name, const char* ext, DataStream* stream, int priority)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!stream || Find(name, ext) != entries.end()) {
+		delete stream;
+		return ticket;
+	}
+	strpos_t size = stream->Remains();
+	if (bytes + size > MaxBytes) {
+		Log(DEBUG, "ResourcePreloader", "Skipping {}.{}, too much is preloaded already.", name, ext);
+		delete stream;
+		return ticket;
+	}
+	bytes += size;
+	if (ticket == NoTicket) {
+		ticket = ++lastTicket;
+	}
+
+	Entry entry;
+	entry.ticket = ticket;
+	entry.name = name;
+	entry.ext = ext;
+	entry.priority = priority;
+	entry.stream = stream;
+	entry.size = size;
+	entries.push_back(std::move(entry));
+
+	if (!worker.joinable()) {
+		worker = std::thread(&ResourcePreloader::Work, this);
+	}
+	lock.unlock();
+	cv.notify_all();
+	return ticket;
+}
+
+void ResourcePreloader::Cancel(Ticket ticket)
+{
+	if (ticket == NoTicket) return;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = entries.begin();
+	while (it != entries.end()) {
+		auto cur = it++;
+		if (cur->ticket != ticket) continue;
+		if (cur->state == State::Reading) {
+			// the worker cleans it up once it is done with it
+			cur->cancelled = true;
+		} else {
+			Discard(cur);
+		}
+	}
+}
+
+bool ResourcePreloader::Pending(Ticket ticket) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (const auto& entry : entries) {
+		if (!entry.cancelled && entry.ticket == ticket) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ResourcePreloader::Has(const ResRef& name, const char* ext) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (const auto& entry : entries) {
+		if (!entry.cancelled && entry.name == name && stricmp(entry.ext.c_str(), ext) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+DataStream* ResourcePreloader::Take(const ResRef& name, const char* ext)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (entries.empty()) return nullptr;
+
+	auto it = Find(name, ext);
+	if (it == entries.end()) return nullptr;
+
+	// nearly done, so it is cheaper to wait than to start over
+	cv.wait(lock, [it]() { return it->state != State::Reading; });
+
+	DataStream* stream;
+	if (it->state == State::Queued) {
+		// the worker didn't get to it yet, so just hand out the original
+		stream = it->stream;
+		it->stream = nullptr;
+	} else if (it->data) {
+		stream = new MemoryStream(it->stream->originalfile, it->data, it->size);
+		it->data = nullptr;
+	} else {
+		// reading failed, let the caller try the normal way
+		stream = nullptr;
+	}
+	Discard(it);
+	return stream;
+}
+
+void ResourcePreloader::Work()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		auto job = entries.end();
+		cv.wait(lock, [&]() {
+			if (stop) return true;
+			for (auto it = entries.begin(); it != entries.end(); ++it) {
+				if (it->state != State::Queued) continue;
+				if (job == entries.end() || it->priority > job->priority) {
+					job = it;
+				}
+			}
+			return job != entries.end();
+		});
+		if (stop) break;
+
+		// entries are never erased while being read, so the iterator stays valid
+		job->state = State::Reading;
+		DataStream* stream = job->stream;
+		strpos_t size = job->size;
+		lock.unlock();
+
+		void* data = malloc(size);
+		if (data && stream->Read(data, size) != strret_t(size)) {
+			free(data);
+			data = nullptr;
+		}
+
+		lock.lock();
+		job->state = State::Ready;
+		job->data = data;
+		if (job->cancelled) {
+			Discard(job);
+		}
+		cv.notify_all();
+	}
+}
+
+}
@@ -0,0 +1,109 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef RESOURCEPRELOADER_H
+#define RESOURCEPRELOADER_H
+
+#include "exports.h"
+
+#include "Resource.h"
+#include "Streams/DataStream.h"
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace GemRB {
+
+/**
+ * @class ResourcePreloader
+ * Reads resource streams into memory on a worker thread, so that opening them
+ * later doesn't have to wait on the disk or the biffs.
+ * Only the raw bytes are loaded, turning them into sprites and other objects
+ * stays on the main thread, since neither the plugins nor the video driver
+ * are safe to use from elsewhere.
+ * Streams are grouped by tickets, which can be cancelled as a whole, and the
+ * ones with the higher priority are read first.
+ * At most MaxBytes are held at once, anything beyond that is left to load normally.
+ */
+class GEM_EXPORT ResourcePreloader {
+public:
+	using Ticket = unsigned int;
+	static const Ticket NoTicket = 0;
+	static const strpos_t MaxBytes = 128 * 1024 * 1024;
+
+private:
+	enum class State {
+		Queued,
+		Reading,
+		Ready
+	};
+
+	struct Entry {
+		Ticket ticket;
+		ResRef name;
+		std::string ext;
+		int priority;
+		State state = State::Queued;
+		bool cancelled = false;
+		DataStream* stream;
+		void* data = nullptr;
+		strpos_t size = 0;
+	};
+
+	std::list<Entry> entries;
+	Ticket lastTicket = NoTicket;
+	// the size of everything queued or read and not taken yet
+	strpos_t bytes = 0;
+
+	mutable std::mutex mutex;
+	std::condition_variable cv;
+	std::thread worker;
+	bool stop = false;
+
+	std::list<Entry>::iterator Find(const ResRef& name, const char* ext);
+	void Discard(std::list<Entry>::iterator);
+	void Work();
+
+public:
+	ResourcePreloader() noexcept = default;
+	ResourcePreloader(const ResourcePreloader&) = delete;
+	~ResourcePreloader();
+	ResourcePreloader& operator=(const ResourcePreloader&) = delete;
+
+	/** Queues the stream to be read into memory, taking ownership of it.
+	 *  Passing NoTicket starts a new batch, the ticket of which is returned,
+	 *  unless nothing was queued. */
+	Ticket Add(Ticket, const ResRef& name, const char* ext, DataStream*, int priority);
+	/** Drops everything belonging to the ticket that wasn't taken yet */
+	void Cancel(Ticket);
+	/** Whether anything of the ticket is still waiting to be taken */
+	bool Pending(Ticket) const;
+	bool Has(const ResRef& name, const char* ext) const;
+	/** Returns the stream for the resource and forgets about it,
+	 *  or nullptr if it wasn't preloaded. Waits if it is being read right now. */
+	DataStream* Take(const ResRef& name, const char* ext);
+};
+
+}
+
+#endif
@@ -374,7 +374,7 @@ void SaveGameIterator::PruneQuickSave(StringView folder) const
 }
 
 /** Save game to given directory */
-static bool DoSaveGame(const char *Path, bool overrideRunning)
+static bool DoSaveGame(const char *Path, bool overrideRunning, int compression)
 {
 	const Game *game = core->GetGame();
 	//saving areas to cache currently in memory
@@ -390,7 +390,7 @@ static bool DoSaveGame(const char *Path, bool overrideRunning)
 
 	//compress files in cache named: .STO and .ARE
 	//no .CRE would be saved in cache
-	if (core->CompressSave(Path, overrideRunning)) {
+	if (core->CompressSave(Path, overrideRunning, compression)) {
 		return false;
 	}
 
@@ -594,7 +594,7 @@ int SaveGameIterator::CreateSaveGame(int index, bool mqs) const
 		return GEM_ERROR;
 	}
 
-	if (!DoSaveGame(Path, overrideRunning)) {
+	if (!DoSaveGame(Path, overrideRunning, core->config.AutoSaveCompression)) {
 		displaymsg->DisplayConstantString(STR_CANTSAVE, GUIColors::XPCHANGE);
 		gc->SetDisplayText(STR_CANTSAVE, 30);
 		return GEM_ERROR;
@@ -658,7 +658,7 @@ int SaveGameIterator::CreateSaveGame(Holder<SaveGame> save, StringView slotname,
 		return GEM_ERROR;
 	}
 
-	if (!DoSaveGame(Path, overrideRunning)) {
+	if (!DoSaveGame(Path, overrideRunning, core->config.SaveCompression)) {
 		displaymsg->DisplayConstantString(STR_CANTSAVE, GUIColors::XPCHANGE);
 		gc->SetDisplayText(STR_CANTSAVE, 30);
 		return GEM_ERROR;
@@ -99,6 +99,8 @@ static ieDword NoExtraDifficultyDmg = 0;
 static int DifficultyLuckMod = 0;
 static int DifficultyDamageMod = 0;
 static int DifficultySaveMod = 0;
+// bumped whenever the above change, since refreshes depend on them (eg. luck)
+static unsigned int ActorConfigGeneration = 0;
 
 //the chance to issue one of the rare select verbal constants
 #define RARE_SELECT_CHANCE 5
@@ -1620,6 +1622,7 @@ GEM_EXPORT void UpdateActorConfig()
 	DifficultyLuckMod = gamedata->GetDifficultyMod(2, GameDifficulty);
 	DifficultyDamageMod = gamedata->GetDifficultyMod(0, GameDifficulty);
 	DifficultySaveMod = gamedata->GetDifficultyMod(3, GameDifficulty);
+	++ActorConfigGeneration;
 
 	// iwd has a config option for leniency
 	core->GetDictionary()->Lookup("Suppress Extra Difficulty Damage", NoExtraDifficultyDmg);
@@ -2760,6 +2763,10 @@ void Actor::AddEffects(EffectQueue&& fx)
 
 void Actor::RefreshEffects(bool first, const stats_t& previous)
 {
+	statsDirty = false;
+	refreshedEffects = fxqueue.GetEffectsCount() != 0;
+	refreshedConfig = ActorConfigGeneration;
+
 	// some VVCs are controlled by stats (and so by PCFs), the rest have 'effect_owned' set
 	for (ScriptedAnimation* vvc : vfxQueue) {
 		if (vvc->effect_owned) vvc->active = false;
@@ -2895,6 +2902,9 @@ void Actor::RefreshEffects(bool first, const stats_t& previous)
 	if (Immobile()) {
 		timeStartStep = game->Ticks;
 	}
+
+	refreshedBase = BaseStats;
+	refreshedModified = Modified;
 }
 
 void Actor::RefreshEffects()
@@ -2903,6 +2913,49 @@ void Actor::RefreshEffects()
 	RefreshEffects(first, ResetStats(first));
 }
 
+// a refresh is a pure function of the stats for most idle creatures,
+// so it only has to be redone once something it depends on changed
+bool Actor::NeedsRefresh() const
+{
+	if (statsDirty || !(InternalFlags & IF_INITIALIZED)) {
+		return true;
+	}
+	// the difficulty or another setting changed
+	if (refreshedConfig != ActorConfigGeneration) {
+		return true;
+	}
+	// effects can do anything on each application (regeneration, poison, expiry ...)
+	if (refreshedEffects || fxqueue.GetEffectsCount()) {
+		return true;
+	}
+	if (checkHP || Immobile()) {
+		return true;
+	}
+	// RefreshPCStats does part of its work based on the game time
+	if (HasPlayerClass()) {
+		// fatigue
+		if (InParty) {
+			return true;
+		}
+		if (GetStat(IE_MORALERECOVERYTIME) && BaseStats[IE_MORALE] != 10 && ShouldModifyMorale()) {
+			return true;
+		}
+		if (GetConHealAmount() && Modified[IE_HITPOINTS] < Modified[IE_MAXHITPOINTS]) {
+			return true;
+		}
+	}
+	if (anims && anims->HasColorMod()) {
+		return true;
+	}
+	for (const auto& trigger : triggers) {
+		if (!(trigger.flags & TEF_PROCESSED_EFFECTS)) {
+			return true;
+		}
+	}
+	// catch direct changes, which bypass SetStat and SetBase
+	return BaseStats != refreshedBase || Modified != refreshedModified;
+}
+
 int Actor::GetProficiency(int proftype) const
 {
 	switch(proftype) {
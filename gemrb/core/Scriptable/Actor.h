@@ -481,6 +481,16 @@ private:
 	stats_t ResetStats(bool init);
 	void RefreshEffects(bool init, const stats_t& prev);
 
+	// the stats as left by the last refresh, to spot any direct changes since
+	stats_t refreshedBase {};
+	stats_t refreshedModified {};
+	// set for changes the refresh depends on, which don't go through the stats
+	bool statsDirty = true;
+	// the last refresh applied effects, so their removal still needs one
+	bool refreshedEffects = true;
+	// the UpdateActorConfig generation the last refresh saw
+	unsigned int refreshedConfig = 0;
+
 public:
 	Actor(void);
 	Actor(const Actor&) = delete;
@@ -510,6 +520,10 @@ public:
 	void CheckPuppet(Actor *puppet, ieDword type);
 	/** Re/Inits the Modified vector */
 	void RefreshEffects();
+	/** returns true if RefreshEffects could change anything since the last call */
+	bool NeedsRefresh() const;
+	/** makes sure the next NeedsRefresh returns true */
+	void InvalidateStats() { statsDirty = true; }
 	void AddEffects(EffectQueue&& eqfx);
 	/** gets saving throws */
 	void RollSaves();
@@ -102,6 +102,8 @@ void Door::UpdateDoor()
 		ImpedeBlocks(open_ib, PathMapFlags::IMPASSABLE);
 		ImpedeBlocks(closed_ib, pmdflags);
 	}
+	area->InvalidateLOS();
+	area->InvalidateWalls();
 
 	InfoPoint *ip = area->TMap->GetInfoPoint(LinkedInfo);
 	if (ip) {
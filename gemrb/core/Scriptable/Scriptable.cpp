@@ -2032,6 +2032,7 @@ void Movable::BumpAway()
 	bumped = true;
 	bumpBackTries = 0;
 	area->AdjustPositionNavmap(Pos);
+	UpdateAreaIndex();
 }
 
 void Movable::BumpBack()
@@ -2145,6 +2146,7 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 		Pos.x += dx;
 		Pos.y += dy;
 		oldPos = Pos;
+		UpdateAreaIndex();
 		if (actor && BlocksSearchMap()) {
 			auto flag = actor->IsPartyMember() ? PathMapFlags::PC : PathMapFlags::NPC;
 			area->tileProps.BlockSearchMap(Map::ConvertCoordToTile(Pos), circleSize, flag);
@@ -2167,6 +2169,7 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 void Movable::AdjustPosition()
 {
 	area->AdjustPosition(Pos);
+	UpdateAreaIndex();
 	ImpedeBumping();
 }
 
@@ -2327,11 +2330,20 @@ void Movable::MoveTo(const Point &Des)
 	Pos = Des;
 	oldPos = Des;
 	Destination = Des;
+	UpdateAreaIndex();
 	if (BlocksSearchMap()) {
 		area->BlockSearchMapFor(this);
 	}
 }
 
+void Movable::UpdateAreaIndex()
+{
+	Actor* actor = As<Actor>();
+	if (actor && area) {
+		area->UpdateActorIndex(actor);
+	}
+}
+
 void Movable::Stop(int flags)
 {
 	Scriptable::Stop(flags);
@@ -501,6 +501,9 @@ protected:
 	bool bumped = false;
 	int pathfindingDistance = circleSize;
 	int randomWalkCounter = 0;
+
+	// tell our area that we moved, so its actor index stays in sync
+	void UpdateAreaIndex();
 public:
 	inline int GetRandomBackoff() const
 	{
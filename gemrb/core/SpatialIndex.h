@@ -0,0 +1,328 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include "globals.h"
+
+#include "Region.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace GemRB {
+
+// the cell math shared by the indexes below
+class SpatialGrid {
+protected:
+	explicit SpatialGrid(int cellSize) noexcept
+	: cellSize(cellSize)
+	{}
+
+	void ResizeGrid(const Size& extent) noexcept
+	{
+		gridSize.w = std::max(1, (extent.w + cellSize - 1) / cellSize);
+		gridSize.h = std::max(1, (extent.h + cellSize - 1) / cellSize);
+	}
+
+	Point CellCoords(const Point& p) const
+	{
+		// floor division, so negative coordinates end up in the first cells
+		int x = p.x >= 0 ? p.x / cellSize : -1;
+		int y = p.y >= 0 ? p.y / cellSize : -1;
+		return Point(Clamp(x, 0, gridSize.w - 1), Clamp(y, 0, gridSize.h - 1));
+	}
+
+	size_t CellIndex(const Point& p) const
+	{
+		const Point cell = CellCoords(p);
+		return cell.y * gridSize.w + cell.x;
+	}
+
+	int cellSize;
+	Size gridSize;
+};
+
+/**
+ * @class SpatialIndex
+ * A uniform grid of buckets over a map, indexing items by a single point.
+ * Queries return the items of all the cells touched by a rectangle, so
+ * callers still need to do their exact (range, circle, LOS) checks, but
+ * only on nearby candidates. Positions outside the grid are clamped to
+ * the border cells, so nothing ever falls out of the index.
+ * Results are returned in insertion order, so code that picks the first
+ * match behaves the same as a linear walk over the original container.
+ * Buckets are kept sorted by insertion, so that single cell queries and
+ * FindFirst don't need to sort at all.
+ */
+
+template <typename T>
+class SpatialIndex : private SpatialGrid {
+public:
+	explicit SpatialIndex(int cellSize = 128) noexcept
+	: SpatialGrid(cellSize)
+	{}
+
+	// (re)initializes the grid for an area of the given size in pixels
+	void Reset(const Size& extent)
+	{
+		ResizeGrid(extent);
+		buckets.clear();
+		buckets.resize(gridSize.Area());
+		slots.clear();
+		nextSeq = 0;
+	}
+
+	// adds a new item (or moves it, if it is already indexed)
+	void Insert(const T& item, const Point& pos)
+	{
+		if (Move(item, pos)) return;
+
+		size_t cell = CellIndex(pos);
+		buckets[cell].push_back({item, nextSeq});
+		slots.emplace(item, Slot{cell, nextSeq});
+		++nextSeq;
+	}
+
+	// updates the position of an indexed item, returns false for unknown items
+	bool Move(const T& item, const Point& pos)
+	{
+		auto it = slots.find(item);
+		if (it == slots.end()) return false;
+
+		Slot& slot = it->second;
+		size_t cell = CellIndex(pos);
+		if (slot.cell == cell) return true;
+
+		EraseFromBucket(slot.cell, item);
+		auto& bucket = buckets[cell];
+		Entry entry = { item, slot.seq };
+		bucket.insert(std::upper_bound(bucket.begin(), bucket.end(), entry, SeqLess), entry);
+		slot.cell = cell;
+		return true;
+	}
+
+	void Remove(const T& item)
+	{
+		auto it = slots.find(item);
+		if (it == slots.end()) return;
+
+		EraseFromBucket(it->second.cell, item);
+		slots.erase(it);
+	}
+
+	bool Contains(const T& item) const
+	{
+		return slots.count(item) != 0;
+	}
+
+	// all items in cells overlapping the inclusive [min, max] rectangle, in insertion order
+	// result is cleared first, so callers can keep reusing its storage
+	void Query(const Point& min, const Point& max, std::vector<T>& result) const
+	{
+		result.clear();
+		if (buckets.empty()) return;
+
+		const Point cmin = CellCoords(min);
+		const Point cmax = CellCoords(max);
+		if (cmin == cmax) {
+			for (const Entry& entry : buckets[cmin.y * gridSize.w + cmin.x]) {
+				result.push_back(entry.item);
+			}
+			return;
+		}
+
+		hits.clear();
+		int sources = 0;
+		for (int y = cmin.y; y <= cmax.y; ++y) {
+			for (int x = cmin.x; x <= cmax.x; ++x) {
+				const auto& bucket = buckets[y * gridSize.w + x];
+				if (bucket.empty()) continue;
+				hits.insert(hits.end(), bucket.begin(), bucket.end());
+				++sources;
+			}
+		}
+
+		if (sources > 1) {
+			std::sort(hits.begin(), hits.end(), SeqLess);
+		}
+		for (const Entry& hit : hits) {
+			result.push_back(hit.item);
+		}
+	}
+
+	std::vector<T> Query(const Point& min, const Point& max) const
+	{
+		std::vector<T> result;
+		Query(min, max, result);
+		return result;
+	}
+
+	std::vector<T> Query(const Region& rgn) const
+	{
+		return Query(rgn.origin, rgn.Maximum());
+	}
+
+	// the first item (in insertion order) within [min, max] that satisfies pred, or a default T
+	// same as the first match in Query, but without collecting or sorting anything
+	template <typename Pred>
+	T FindFirst(const Point& min, const Point& max, Pred pred) const
+	{
+		T found = T();
+		if (buckets.empty()) return found;
+
+		unsigned long foundSeq = std::numeric_limits<unsigned long>::max();
+		const Point cmin = CellCoords(min);
+		const Point cmax = CellCoords(max);
+		for (int y = cmin.y; y <= cmax.y; ++y) {
+			for (int x = cmin.x; x <= cmax.x; ++x) {
+				for (const Entry& entry : buckets[y * gridSize.w + x]) {
+					// the rest of the bucket is newer, so it can't win anymore
+					if (entry.seq >= foundSeq) break;
+					if (!pred(entry.item)) continue;
+					found = entry.item;
+					foundSeq = entry.seq;
+					break;
+				}
+			}
+		}
+		return found;
+	}
+
+private:
+	struct Entry {
+		T item;
+		unsigned long seq;
+	};
+
+	struct Slot {
+		size_t cell;
+		unsigned long seq;
+	};
+
+	static bool SeqLess(const Entry& a, const Entry& b) noexcept
+	{
+		return a.seq < b.seq;
+	}
+
+	void EraseFromBucket(size_t cell, const T& item)
+	{
+		auto& bucket = buckets[cell];
+		for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+			if (it->item == item) {
+				bucket.erase(it);
+				return;
+			}
+		}
+	}
+
+	std::vector<std::vector<Entry>> buckets;
+	std::unordered_map<T, Slot> slots;
+	unsigned long nextSeq = 0;
+	// scratch space for merging buckets in Query
+	mutable std::vector<Entry> hits;
+};
+
+/**
+ * @class RegionIndex
+ * The counterpart of SpatialIndex for items covering an area, like trigger regions.
+ * Every item is filed under all the cells its rectangles touch, so a query returns
+ * the items that could overlap it, each once and in insertion order.
+ * There is no removal, since the items are expected to stay put; rebuild instead.
+ */
+
+template <typename T>
+class RegionIndex : private SpatialGrid {
+public:
+	explicit RegionIndex(int cellSize = 128) noexcept
+	: SpatialGrid(cellSize)
+	{}
+
+	void Reset(const Size& extent)
+	{
+		ResizeGrid(extent);
+		buckets.clear();
+		buckets.resize(gridSize.Area());
+		nextSeq = 0;
+	}
+
+	void Insert(const T& item, const std::vector<Region>& rects)
+	{
+		for (const Region& rect : rects) {
+			const Point cmin = CellCoords(rect.origin);
+			const Point cmax = CellCoords(rect.Maximum());
+			for (int y = cmin.y; y <= cmax.y; ++y) {
+				for (int x = cmin.x; x <= cmax.x; ++x) {
+					auto& bucket = buckets[y * gridSize.w + x];
+					// the rectangles of one item may share cells
+					if (bucket.empty() || bucket.back().seq != nextSeq) {
+						bucket.push_back({item, nextSeq});
+					}
+				}
+			}
+		}
+		++nextSeq;
+	}
+
+	// all items filed in cells overlapping the inclusive [min, max] rectangle, in insertion order
+	std::vector<T> Query(const Point& min, const Point& max) const
+	{
+		std::vector<T> result;
+		if (buckets.empty()) return result;
+
+		const Point cmin = CellCoords(min);
+		const Point cmax = CellCoords(max);
+		std::vector<Entry> hits;
+		for (int y = cmin.y; y <= cmax.y; ++y) {
+			for (int x = cmin.x; x <= cmax.x; ++x) {
+				const auto& bucket = buckets[y * gridSize.w + x];
+				hits.insert(hits.end(), bucket.begin(), bucket.end());
+			}
+		}
+
+		std::sort(hits.begin(), hits.end(), [](const Entry& a, const Entry& b) {
+			return a.seq < b.seq;
+		});
+		hits.erase(std::unique(hits.begin(), hits.end(), [](const Entry& a, const Entry& b) {
+			return a.seq == b.seq;
+		}), hits.end());
+		result.reserve(hits.size());
+		for (const Entry& hit : hits) {
+			result.push_back(hit.item);
+		}
+		return result;
+	}
+
+private:
+	struct Entry {
+		T item;
+		unsigned long seq;
+	};
+
+	std::vector<std::vector<Entry>> buckets;
+	unsigned long nextSeq = 0;
+};
+
+}
+
+#endif
@@ -27,7 +27,7 @@
 namespace GemRB {
 
 MemoryStream::MemoryStream(const char *name, void* data, strpos_t size)
-	: data((char*)data)
+	: data((char*)data), capacity(size)
 {
 	this->size = size;
 	ExtractFileFromPath(filename, name);
@@ -64,9 +64,18 @@ strret_t MemoryStream::Read(void* dest, strpos_t length)
 
 strret_t MemoryStream::Write(const void* src, strpos_t length)
 {
-	if (Pos+length>size ) {
-		//error("MemoryStream", "We don't support appending to memory streams yet.");
-		return Error;
+	if (Pos + length > capacity) {
+		// appending, grow the buffer geometrically
+		strpos_t newCapacity = std::max(Pos + length, capacity * 2);
+		char* grown = static_cast<char*>(realloc(data, newCapacity));
+		if (!grown) {
+			return Error;
+		}
+		data = grown;
+		capacity = newCapacity;
+	}
+	if (Pos + length > size) {
+		size = Pos + length;
 	}
 	memcpy(data+Pos, src, length);
 	Pos += length;
@@ -28,39 +28,42 @@ namespace GemRB {
 
 /////////////////////////////////////////////////////////////////////////////
 // private inlines 
-inline bool Variables::MyCopyKey(char*& dest, const key_t& key) const
+// keys are normalized once, when they are stored
+inline char* Variables::MyCopyKey(const key_t& key) const
 {
-	size_t j = std::count(key.begin(), key.end(), ' ');
-	dest = (char *) malloc(key.length() - j + 1);
+	char* dest = (char *) malloc(key.length() + 1);
 
-	j = 0;
+	size_t j = 0;
 	for (const auto& chr : key) {
+		if (!m_lParseKey) {
+			dest[j++] = chr;
+			continue;
+		}
+		//the original engine ignores spaces in variable names
 		if (chr == ' ')
 			continue;
 		dest[j++] = tolower(chr);
 	}
 	dest[j] = 0;
-	return true;
+	return dest;
 }
 
-inline bool Variables::MyCompareKey(const key_t& key, key_t str) const
+inline bool Variables::MyCompareKey(const char* key, const key_t& str) const
 {
-	// we know 'key' cannot contain spaces (created via MyCopyKey)
-	// therefore str.length() cannot be < key.length()
-	if (str.length() < key.length()) {
-		return false;
-	}
-
-	size_t s = 0;
-	size_t end = str.length();
-	for (size_t k = 0; s < end; ++s) {
-		if (str[s] == ' ')
+	size_t k = 0;
+	for (const auto& chr : str) {
+		if (m_lParseKey && chr == ' ')
 			continue;
-		if (tolower(key[k++]) != tolower(str[s]))
+		if (key[k] == 0)
 			return false;
+		// stored keys are already lowercase when parsing
+		char stored = m_lParseKey ? key[k] : tolower(key[k]);
+		if (stored != tolower(chr))
+			return false;
+		k++;
 	}
 
-	return s == end;
+	return key[k] == 0;
 }
 
 inline unsigned int Variables::MyHashKey(const key_t& key) const
@@ -69,170 +72,131 @@ inline unsigned int Variables::MyHashKey(const key_t& key) const
 
 	unsigned int nHash = 0;
 	for (const auto& chr : key) {
-		//the original engine ignores spaces in variable names
-		if (chr == ' ')
+		if (m_lParseKey && chr == ' ')
 			continue;
 		nHash = (nHash << 5) + nHash + tolower(chr);
 	}
-	return nHash;
+	// only the low bits pick the slot
+	return nHash ^ (nHash >> 16);
 }
 /////////////////////////////////////////////////////////////////////////////
 // functions
 Variables::iterator Variables::GetNextAssoc(iterator rNextPosition, key_t& rKey,
 	ieDword& rValue) const
 {
-	assert( m_pHashTable != NULL ); // never call on empty map
+	assert( m_pSlots != NULL ); // never call on empty map
 
+	const Variables::MyAssoc* end = m_pSlots + m_nCapacity;
 	Variables::MyAssoc *pAssocRet = rNextPosition;
 
 	if (pAssocRet == NULL) {
 		// find the first association
-		for (unsigned int nBucket = 0; nBucket < m_nHashTableSize; nBucket++)
-			if (( pAssocRet = m_pHashTable[nBucket] ) != NULL)
-				break;
-		assert( pAssocRet != NULL ); // must find something
+		pAssocRet = m_pSlots;
+		while (pAssocRet != end && pAssocRet->key == NULL) {
+			pAssocRet++;
+		}
+		assert( pAssocRet != end ); // must find something
 	}
-	Variables::MyAssoc* pAssocNext;
-	if (( pAssocNext = pAssocRet->pNext ) == NULL) {
-		// go to next bucket
-		for (size_t nBucket = pAssocRet->nHashValue + 1;
-			nBucket < m_nHashTableSize;
-			nBucket++)
-			if (( pAssocNext = m_pHashTable[nBucket] ) != NULL)
-				break;
+	Variables::MyAssoc* pAssocNext = pAssocRet + 1;
+	while (pAssocNext != end && pAssocNext->key == NULL) {
+		pAssocNext++;
 	}
 
 	// fill in return data
 	rKey = key_t(pAssocRet->key);
 	rValue = pAssocRet->Value.nValue;
-	return pAssocNext;
+	return pAssocNext == end ? NULL : pAssocNext;
 }
 
-Variables::Variables(int nBlockSize, int nHashTableSize)
+void Variables::RemoveAll(ReleaseFun fun)
 {
-	assert( nBlockSize > 0 );
-	assert( nHashTableSize > 16 );
+	// destroy elements (values and keys)
+	for (unsigned int i = 0; i < m_nCapacity; i++) {
+		Variables::MyAssoc& slot = m_pSlots[i];
+		if (slot.key == NULL) {
+			continue;
+		}
+		if (fun) {
+			fun((void *) slot.Value.sValue);
+		} else if (m_type == GEM_VARIABLES_STRING) {
+			free(slot.Value.sValue);
+		}
+		free(slot.key);
+	}
 
-	m_pHashTable = NULL;
-	m_nHashTableSize = nHashTableSize; // default size
+	free(m_pSlots);
+	m_pSlots = NULL;
+	m_nCapacity = 0;
 	m_nCount = 0;
-	m_lParseKey = false;
-	m_pFreeList = NULL;
-	m_pBlocks = NULL;
-	m_nBlockSize = nBlockSize;
-	m_type = GEM_VARIABLES_INT;
 }
 
-void Variables::InitHashTable(unsigned int nHashSize, bool bAllocNow)
-	//
-	// Used to force allocation of a hash table or to override the default
-	// hash table size of (which is fairly small)
+Variables::~Variables()
 {
-	assert( m_nCount == 0 );
-	assert( nHashSize > 16 );
-
-	if (m_pHashTable != NULL) {
-		// free hash table
-		free(m_pHashTable);
-		m_pHashTable = NULL;
-	}
-
-	if (bAllocNow) {
-		m_pHashTable =(Variables::MyAssoc **) malloc(sizeof( Variables::MyAssoc *) * nHashSize);
-		memset( m_pHashTable, 0, sizeof( Variables::MyAssoc * ) * nHashSize );
-	}
-	m_nHashTableSize = nHashSize;
+	RemoveAll(NULL);
 }
 
-void Variables::RemoveAll(ReleaseFun fun)
+void Variables::Grow()
 {
-	if (m_pHashTable != NULL) {
-		// destroy elements (values and keys)
-		for (unsigned int nHash = 0; nHash < m_nHashTableSize; nHash++) {
-			for (auto pAssoc = m_pHashTable[nHash]; pAssoc != nullptr; pAssoc = pAssoc->pNext) {
-				if (fun) {
-					fun((void *) pAssoc->Value.sValue);
-				}
-				else if (m_type == GEM_VARIABLES_STRING) {
-					if (pAssoc->Value.sValue) {
-						free( pAssoc->Value.sValue );
-						pAssoc->Value.sValue = NULL;
-					}
-				}
-				if (pAssoc->key) {
-					free(pAssoc->key);
-					pAssoc->key = NULL;
-				}
-			}
-		}
-	}
+	Variables::MyAssoc* oldSlots = m_pSlots;
+	unsigned int oldCapacity = m_nCapacity;
 
-	// free hash table
-	free(m_pHashTable);
-	m_pHashTable = NULL;
+	m_nCapacity = oldCapacity ? oldCapacity * 2 : 16;
+	m_pSlots = (Variables::MyAssoc *) calloc(m_nCapacity, sizeof(Variables::MyAssoc));
+	assert( m_pSlots != NULL );
 
-	m_nCount = 0;
-	m_pFreeList = NULL;
-	MemBlock* p = m_pBlocks;
-	while (p != NULL) {
-		MemBlock* pNext = p->pNext;
-		free(p);
-		p = pNext;
+	unsigned int mask = m_nCapacity - 1;
+	for (unsigned int i = 0; i < oldCapacity; i++) {
+		if (oldSlots[i].key == NULL) {
+			continue;
+		}
+		unsigned int j = oldSlots[i].nHashValue & mask;
+		while (m_pSlots[j].key) {
+			j = (j + 1) & mask;
+		}
+		m_pSlots[j] = oldSlots[i];
 	}
-	m_pBlocks = NULL;
+	free(oldSlots);
 }
 
-Variables::~Variables()
+Variables::MyAssoc* Variables::NewAssoc(const key_t& key, unsigned int nHash)
 {
-	RemoveAll(NULL);
-}
+	// keep the load under 3/4, so the probe sequences stay short
+	if ((m_nCount + 1) * 4 > int(m_nCapacity) * 3) {
+		Grow();
+	}
 
-Variables::MyAssoc* Variables::NewAssoc(const key_t& key)
-{
-	if (m_pFreeList == NULL) {
-		// add another block
-		Variables::MemBlock* newBlock = ( Variables::MemBlock* ) malloc( m_nBlockSize*sizeof( Variables::MyAssoc ) + sizeof( Variables::MemBlock ));
-		assert( newBlock != NULL ); // we must have something
-		newBlock->pNext = m_pBlocks;
-		m_pBlocks = newBlock;
-
-		// chain them into free list
-		Variables::MyAssoc* pAssoc = ( Variables::MyAssoc* ) ( newBlock + 1 );
-		for (int i = 0; i < m_nBlockSize; i++) {
-			pAssoc->pNext = m_pFreeList;
-			m_pFreeList = pAssoc++;
-		}
+	unsigned int mask = m_nCapacity - 1;
+	unsigned int i = nHash & mask;
+	while (m_pSlots[i].key) {
+		i = (i + 1) & mask;
 	}
-	
-	Variables::MyAssoc* pAssoc = m_pFreeList;
-	m_pFreeList = m_pFreeList->pNext;
+
+	Variables::MyAssoc* pAssoc = &m_pSlots[i];
+	pAssoc->key = MyCopyKey(key);
+	pAssoc->Value.sValue = NULL;
+	pAssoc->nHashValue = nHash;
 	m_nCount++;
 	assert( m_nCount > 0 ); // make sure we don't overflow
-	if (m_lParseKey) {
-		MyCopyKey( pAssoc->key, key );
-	} else {
-		size_t len = key.length();
-		pAssoc->key = (char *) malloc(len + 1);
-		if (pAssoc->key) {
-			memcpy(pAssoc->key, key.begin(), len);
-			pAssoc->key[len] = 0;
-		}
-	}
-#ifdef _DEBUG
-	pAssoc->Value.nValue = 0xcccccccc; //invalid value
-	pAssoc->nHashValue = 0xcccccccc; //invalid value
-#endif
 	return pAssoc;
 }
 
 void Variables::FreeAssoc(Variables::MyAssoc* pAssoc)
 {
-	if (pAssoc->key) {
-		free(pAssoc->key);
-		pAssoc->key = NULL;
+	free(pAssoc->key);
+
+	// shift the following entries back instead of leaving tombstones
+	unsigned int mask = m_nCapacity - 1;
+	unsigned int hole = unsigned(pAssoc - m_pSlots);
+	for (unsigned int i = (hole + 1) & mask; m_pSlots[i].key; i = (i + 1) & mask) {
+		unsigned int home = m_pSlots[i].nHashValue & mask;
+		// only if the hole is between its home slot and where it is now
+		if (((i - home) & mask) >= ((i - hole) & mask)) {
+			m_pSlots[hole] = m_pSlots[i];
+			hole = i;
+		}
 	}
-	pAssoc->pNext = m_pFreeList;
-	m_pFreeList = pAssoc;
+	m_pSlots[hole].key = NULL;
+
 	m_nCount--;
 	assert( m_nCount >= 0 ); // make sure we don't underflow
 
@@ -250,22 +214,18 @@ Variables::MyAssoc* Variables::GetAssocAt(const key_t& key, unsigned int& nHash)
 		return nullptr;
 	}
 
-	nHash = MyHashKey( key ) % m_nHashTableSize;
+	nHash = MyHashKey( key );
 
-	if (m_pHashTable == NULL) {
+	if (m_pSlots == NULL) {
 		return NULL;
 	}
 
 	// see if it exists
-	for (auto pAssoc = m_pHashTable[nHash]; pAssoc != nullptr; pAssoc = pAssoc->pNext) {
-		if (m_lParseKey) {
-			if (MyCompareKey(key_t(pAssoc->key), key)) {
-				return pAssoc;
-			}
-		} else {
-			if (!strnicmp(pAssoc->key, key.c_str(), key.length())) {
-				return pAssoc;
-			}
+	unsigned int mask = m_nCapacity - 1;
+	for (unsigned int i = nHash & mask; m_pSlots[i].key; i = (i + 1) & mask) {
+		// the full hash rules out nearly all the other keys without comparing them
+		if (m_pSlots[i].nHashValue == nHash && MyCompareKey(m_pSlots[i].key, key)) {
+			return &m_pSlots[i];
 		}
 	}
 
@@ -344,14 +304,8 @@ void Variables::SetAtCString(const key_t& key, const char* str)
 
 	assert( m_type == GEM_VARIABLES_STRING );
 	if (( pAssoc = GetAssocAt( key, nHash ) ) == NULL) {
-		if (m_pHashTable == NULL)
-			InitHashTable( m_nHashTableSize );
-
 		// it doesn't exist, add a new Association
-		pAssoc = NewAssoc( key );
-		// put into hash table
-		pAssoc->pNext = m_pHashTable[nHash];
-		m_pHashTable[nHash] = pAssoc;
+		pAssoc = NewAssoc( key, nHash );
 	} else {
 		if (pAssoc->Value.sValue) {
 			free( pAssoc->Value.sValue );
@@ -362,7 +316,6 @@ void Variables::SetAtCString(const key_t& key, const char* str)
 	//set value only if we have a key
 	if (pAssoc->key) {
 		pAssoc->Value.sValue = strdup(str);
-		pAssoc->nHashValue = nHash;
 	}
 }
 
@@ -373,14 +326,8 @@ void Variables::SetAt(const key_t& key, void* value)
 
 	assert( m_type == GEM_VARIABLES_POINTER );
 	if (( pAssoc = GetAssocAt( key, nHash ) ) == NULL) {
-		if (m_pHashTable == NULL)
-			InitHashTable( m_nHashTableSize );
-
 		// it doesn't exist, add a new Association
-		pAssoc = NewAssoc( key );
-		// put into hash table
-		pAssoc->pNext = m_pHashTable[nHash];
-		m_pHashTable[nHash] = pAssoc;
+		pAssoc = NewAssoc( key, nHash );
 	} else {
 		if (pAssoc->Value.sValue) {
 			free( pAssoc->Value.sValue );
@@ -391,7 +338,6 @@ void Variables::SetAt(const key_t& key, void* value)
 	//set value only if we have a key
 	if (pAssoc->key) {
 		pAssoc->Value.pValue = value;
-		pAssoc->nHashValue = nHash;
 	}
 
 }
@@ -411,19 +357,12 @@ void Variables::SetAt(const key_t& key, ieDword value, bool nocreate)
 			return;
 		}
 
-		if (m_pHashTable == NULL)
-			InitHashTable( m_nHashTableSize );
-
 		// it doesn't exist, add a new Association
-		pAssoc = NewAssoc( key );
-		// put into hash table
-		pAssoc->pNext = m_pHashTable[nHash];
-		m_pHashTable[nHash] = pAssoc;
+		pAssoc = NewAssoc( key, nHash );
 	}
 	//set value only if we have a key
 	if (pAssoc->key) {
 		pAssoc->Value.nValue = value;
-		pAssoc->nHashValue = nHash;
 	}
 }
 
@@ -435,22 +374,6 @@ void Variables::Remove(const key_t& key)
 	pAssoc = GetAssocAt( key, nHash );
 	if (!pAssoc) return; // not in there
 
-	if (pAssoc == m_pHashTable[nHash]) {
-		// head
-		m_pHashTable[nHash] = pAssoc->pNext;
-	} else {
-		Variables::MyAssoc* prev = m_pHashTable[nHash];
-		// Room for optimization: make each bucket a doubly linked
-		// list to make removes from a bucket O(1).
-		// (This will have limited use in gemrb's case, because we
-		// use relatively large tables and small buckets.)
-		while (prev->pNext != pAssoc) {
-			prev = prev->pNext;
-			assert( prev != NULL );
-		}
-		prev->pNext = pAssoc->pNext;		
-	}
-	pAssoc->pNext = 0;
 	FreeAssoc(pAssoc);
 }
 
@@ -506,17 +429,19 @@ void Variables::DebugDump() const
 	}
 	Log (DEBUG, "Variables", "Item type: {}", poi);
 	Log (DEBUG, "Variables", "Item count: {}", m_nCount);
-	Log (DEBUG, "Variables", "HashTableSize: {}", m_nHashTableSize);
-	for (unsigned int nHash = 0; nHash < m_nHashTableSize; nHash++) {
-		for (auto pAssoc = m_pHashTable[nHash]; pAssoc != nullptr; pAssoc = pAssoc->pNext) {
-			switch(m_type) {
-			case GEM_VARIABLES_STRING:
-				Log (DEBUG, "Variables", "{} = {}", pAssoc->key, pAssoc->Value.sValue);
-				break;
-			default:
-				Log (DEBUG, "Variables", "{} = {}", pAssoc->key, pAssoc->Value.nValue);
-				break;
-			}
+	Log (DEBUG, "Variables", "HashTableSize: {}", m_nCapacity);
+	for (unsigned int i = 0; i < m_nCapacity; i++) {
+		const Variables::MyAssoc& slot = m_pSlots[i];
+		if (slot.key == NULL) {
+			continue;
+		}
+		switch(m_type) {
+		case GEM_VARIABLES_STRING:
+			Log (DEBUG, "Variables", "{} = {}", slot.key, slot.Value.sValue);
+			break;
+		default:
+			Log (DEBUG, "Variables", "{} = {}", slot.key, slot.Value.nValue);
+			break;
 		}
 	}
 }
@@ -41,28 +41,25 @@ using ReleaseFun = void (*)(void*);
 
 class GEM_EXPORT Variables {
 protected:
-	// Association
+	// Association, a slot of the open addressed table
 	class MyAssoc {
-		MyAssoc* pNext;
+		// normalized in ParseKey mode, nullptr for free slots
 		char* key;
 		union {
 			ieDword nValue;
 			char* sValue;
 			void* pValue;
 		} Value;
-		unsigned long nHashValue;
+		unsigned int nHashValue;
 		friend class Variables;
 	};
-	struct MemBlock {
-		MemBlock* pNext;
-	};
 public:
 	// abstract iteration position
 	using iterator = MyAssoc*;
 	using key_t = StringView;
 
 	// Construction
-	explicit Variables(int nBlockSize = 10, int nHashTableSize = 2049);
+	Variables() noexcept = default;
 	Variables(const Variables&) = delete;
 	~Variables();
 	Variables& operator=(const Variables&) = delete;
@@ -131,7 +128,6 @@ public:
 	void SetAt(const key_t&, ieDword newValue, bool nocreate=false);
 	void Remove(const key_t&);
 	void RemoveAll(ReleaseFun fun);
-	void InitHashTable(unsigned int hashSize, bool bAllocNow = true);
 
 	iterator GetNextAssoc(iterator rNextPosition, key_t& rKey,
 		ieDword& rValue) const;
@@ -140,20 +136,19 @@ public:
 	void DebugDump() const;
 	// Implementation
 protected:
-	Variables::MyAssoc** m_pHashTable;
-	unsigned int m_nHashTableSize;
-	bool m_lParseKey;
-	int m_nCount;
-	Variables::MyAssoc* m_pFreeList;
-	MemBlock* m_pBlocks;
-	int m_nBlockSize;
-	int m_type; //could be string or ieDword 
-
-	Variables::MyAssoc* NewAssoc(const key_t&);
+	// linear probing over a power of two sized table, grown at 3/4 load
+	Variables::MyAssoc* m_pSlots = nullptr;
+	unsigned int m_nCapacity = 0;
+	bool m_lParseKey = false;
+	int m_nCount = 0;
+	int m_type = GEM_VARIABLES_INT; //could be string or ieDword
+
+	Variables::MyAssoc* NewAssoc(const key_t&, unsigned int nHash);
 	void FreeAssoc(Variables::MyAssoc*);
 	Variables::MyAssoc* GetAssocAt(const key_t&, unsigned int&) const;
-	inline bool MyCopyKey(char*& dest, const key_t&) const;
-	inline bool MyCompareKey(const key_t&, key_t str) const;
+	void Grow();
+	inline char* MyCopyKey(const key_t&) const;
+	inline bool MyCompareKey(const char* key, const key_t& str) const;
 	inline unsigned int MyHashKey(const key_t&) const;
 	
 	void SetAtCString(const key_t&, const char* newValue);
@@ -23,6 +23,11 @@
 #include "RLE.h"
 #include "Logging/Logging.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXELS_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace GemRB {
 
 IPixelIterator* PixelFormatIterator::InitImp(void* pixel, int pitch) const noexcept
@@ -251,4 +256,88 @@ const Point& PixelFormatIterator::Position() const noexcept
 	return imp->Position();
 }
 
+void ReadRGBASpan(const PixelFormat& fmt, const uint32_t* pixels, int step, Color* out, int count) noexcept
+{
+	assert(fmt.IsRGBA32());
+	for (int i = 0; i < count; ++i, pixels += step) {
+		uint32_t pixel = *pixels;
+		Color& c = out[i];
+		c.r = pixel >> fmt.Rshift;
+		c.g = pixel >> fmt.Gshift;
+		c.b = pixel >> fmt.Bshift;
+		if (fmt.Amask) {
+			c.a = pixel >> fmt.Ashift;
+		} else {
+			c.a = (fmt.HasColorKey && pixel == fmt.ColorKey) ? 0 : 255;
+		}
+	}
+}
+
+void WriteRGBASpan(const PixelFormat& fmt, const Color* in, uint32_t* pixels, int step, int count) noexcept
+{
+	assert(fmt.IsRGBA32());
+	for (int i = 0; i < count; ++i, pixels += step) {
+		const Color& c = in[i];
+		*pixels = uint32_t(c.r) << fmt.Rshift
+			| uint32_t(c.g) << fmt.Gshift
+			| uint32_t(c.b) << fmt.Bshift
+			| (uint32_t(c.a) << fmt.Ashift & fmt.Amask);
+	}
+}
+
+#ifdef PIXELS_SSE2
+static_assert(sizeof(Color) == 4, "Color needs to be packed for the vector loads.");
+
+// two pixels per register, each channel widened to 16 bits
+static inline __m128i BlendPixels(__m128i src, __m128i dst, const __m128i* tint) noexcept
+{
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i full = _mm_set1_epi16(255);
+	const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+
+	if (tint) {
+		// the alpha lanes of the tint are 256, so alpha passes unchanged
+		src = _mm_srli_epi16(_mm_mullo_epi16(src, *tint), 8);
+	}
+
+	__m128i alpha = _mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3));
+	alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+	// dst.a = src.a + ... is the same as the color formula with 255 in place of the src alpha channel
+	src = _mm_or_si128(_mm_andnot_si128(alphaLanes, src), _mm_and_si128(alphaLanes, full));
+
+	__m128i s = _mm_mullo_epi16(alpha, src);
+	__m128i d = _mm_mullo_epi16(_mm_sub_epi16(full, alpha), dst);
+	// the same DIV255 approximation as ShaderBlend, none of it can overflow 16 bits
+	s = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(s, one), _mm_srli_epi16(s, 8)), 8);
+	d = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(d, one), _mm_srli_epi16(d, 8)), 8);
+	return _mm_add_epi16(s, d);
+}
+#endif
+
+void BlendSpan(const Color* src, Color* dst, int count, const Color* tint) noexcept
+{
+	int i = 0;
+#ifdef PIXELS_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	__m128i tintv = zero;
+	if (tint) {
+		tintv = _mm_set_epi16(256, tint->b, tint->g, tint->r, 256, tint->b, tint->g, tint->r);
+	}
+	for (; i + 4 <= count; i += 4) {
+		__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+		__m128i lo = BlendPixels(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), tint ? &tintv : nullptr);
+		__m128i hi = BlendPixels(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), tint ? &tintv : nullptr);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; i < count; ++i) {
+		Color c = src[i];
+		if (tint) {
+			ShaderTint(*tint, c);
+		}
+		ShaderBlend<true>(c, dst[i]);
+	}
+}
+
 }
@@ -90,6 +90,13 @@ struct GEM_EXPORT PixelFormat {
 			true, std::move(pal)
 		};
 	}
+
+	// 32bpp with 8 bit channels (alpha optional), the layout the span kernels work on
+	bool IsRGBA32() const noexcept {
+		return Bpp == 4 && !RLE
+			&& Rmask == 0xffu << Rshift && Gmask == 0xffu << Gshift && Bmask == 0xffu << Bshift
+			&& (Amask == 0 || Amask == 0xffu << Ashift);
+	}
 };
 
 #pragma pack(push,1)
@@ -199,6 +206,14 @@ struct SrcRGBA : RGBBlender {
 	}
 };
 
+// row ("span") kernels, avoiding the per pixel virtual calls of the iterators
+// the read/write functions require fmt.IsRGBA32(); step is +1 or -1 for mirrored rows
+GEM_EXPORT void ReadRGBASpan(const PixelFormat& fmt, const uint32_t* pixels, int step, Color* out, int count) noexcept;
+GEM_EXPORT void WriteRGBASpan(const PixelFormat& fmt, const Color* in, uint32_t* pixels, int step, int count) noexcept;
+// ShaderBlend<true> for a whole row, optionally tinting src first (with a shift of 8)
+// src alpha must already have the mask applied; a src alpha of 0 leaves dst unchanged
+GEM_EXPORT void BlendSpan(const Color* src, Color* dst, int count, const Color* tint = nullptr) noexcept;
+
 enum class SHADER {
 	NONE,
 	BLEND,
@@ -276,6 +291,27 @@ public:
 
 		blender(c, dst);
 	}
+
+	// the same as calling the above for every pixel of a row, with the common cases vectorized
+	// src is used as scratch space
+	void operator()(Color* src, Color* dst, const uint8_t* mask, int count) const {
+		bool vectorized = SRCALPHA && blender == &ShaderBlend<true>
+			&& (SHADE == SHADER::NONE || (SHADE == SHADER::TINT && shift == 8));
+		if (!vectorized) {
+			for (int i = 0; i < count; ++i) {
+				RGBBlendingPipeline::operator()(src[i], dst[i], mask[i]);
+			}
+			return;
+		}
+
+		for (int i = 0; i < count; ++i) {
+			Color& c = src[i];
+			if (c.a && mask[i]) {
+				c.a = (255 - mask[i]) + (c.a * mask[i]);
+			}
+		}
+		BlendSpan(src, dst, count, SHADE == SHADER::TINT ? &tint : nullptr);
+	}
 };
 
 struct GEM_EXPORT IPixelIterator
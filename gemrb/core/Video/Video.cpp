@@ -139,6 +139,7 @@ int Video::SwapBuffers(unsigned int fpscap)
 	drawingBuffers.clear();
 	drawingBuffer = NULL;
 	SetScreenClip(NULL);
+	UpdateRenderStats();
 
 	if (fpscap) {
 		tick_t lim = 1000/fpscap;
@@ -155,6 +156,25 @@ int Video::SwapBuffers(unsigned int fpscap)
 	return PollEvents();
 }
 
+void Video::UpdateRenderStats()
+{
+	lastFrameStats = frameStats;
+	frameStats = RenderStats();
+
+	if (!LogEnabled(DEBUG, "Video")) return;
+
+	statsTotal.drawCalls += lastFrameStats.drawCalls;
+	statsTotal.batches += lastFrameStats.batches;
+	statsTotal.batchedSprites += lastFrameStats.batchedSprites;
+	if (++statsFrames < 300) return;
+
+	Log(DEBUG, "Video", "Per frame over the last {} frames: {:.1f} draw calls, {:.1f} batches with {:.1f} sprites",
+		statsFrames, statsTotal.drawCalls / float(statsFrames), statsTotal.batches / float(statsFrames),
+		statsTotal.batchedSprites / float(statsFrames));
+	statsFrames = 0;
+	statsTotal = RenderStats();
+}
+
 void Video::SetScreenClip(const Region* clip)
 {
 	screenClip = Region(Point(), screenSize);
@@ -86,8 +86,19 @@ public:
 		YV12    // YUV format for BIK videos
 	};
 
+	// draw submission counters for a single frame, filled in by the drivers
+	struct RenderStats {
+		unsigned long drawCalls = 0; // every submission to the backend, batched or not
+		unsigned long batches = 0; // submissions that merged sprites into one call
+		unsigned long batchedSprites = 0; // sprites drawn as part of a batch
+	};
+
 protected:
 	tick_t lastTime = 0;
+	RenderStats frameStats;
+	RenderStats lastFrameStats;
+	unsigned int statsFrames = 0;
+	RenderStats statsTotal;
 	EventMgr* EvntManager = nullptr;
 	Region screenClip;
 	Size screenSize;
@@ -113,6 +124,7 @@ protected:
 	virtual void Wait(uint32_t) = 0;
 	void DestroyBuffer(VideoBuffer*);
 	void DestroyBuffers();
+	void UpdateRenderStats();
 
 private:
 	virtual VideoBuffer* NewVideoBuffer(const Region&, BufferFormat)=0;
@@ -146,6 +158,8 @@ public:
 	bool GetFullscreenMode() const;
 	/** Swaps displayed and back buffers */
 	int SwapBuffers(unsigned int fpscap = 30);
+	/** Draw submission counters of the last presented frame */
+	const RenderStats& GetRenderStats() const { return lastFrameStats; }
 	VideoBufferPtr CreateBuffer(const Region&, BufferFormat = BufferFormat::DISPLAY);
 	void PushDrawingBuffer(const VideoBufferPtr&);
 	void PopDrawingBuffer();
@@ -23,6 +23,8 @@
 #include "Interface.h"
 #include "Streams/FileStream.h"
 
+#include <algorithm>
+
 using namespace GemRB;
 
 #define SIGNLENGTH 256      //if a 2da has longer default value, change this
@@ -32,6 +34,40 @@ static bool StringCompKey(const std::string& str, TableMgr::key_t key)
 	return stricmp(str.c_str(), key.c_str()) == 0;
 }
 
+// matches StringCompKey, which stops at the first null
+static size_t HashName(const char* str)
+{
+	size_t hash = 0;
+	for (; *str; ++str) {
+		hash = hash * 31 + tolower(*str);
+	}
+	return hash;
+}
+
+static void AddToIndex(std::unordered_map<size_t, std::vector<TableMgr::index_t>>& index,
+					   const std::string& name, TableMgr::index_t pos)
+{
+	index[HashName(name.c_str())].push_back(pos);
+}
+
+// the first position from start on with a matching name
+template <typename LOOKUP>
+static TableMgr::index_t FindInIndex(const std::unordered_map<size_t, std::vector<TableMgr::index_t>>& index,
+									 TableMgr::key_t key, TableMgr::index_t start, LOOKUP&& nameAt)
+{
+	auto it = index.find(HashName(key.c_str()));
+	if (it == index.end()) {
+		return TableMgr::npos;
+	}
+	const auto& positions = it->second;
+	for (auto pos = std::lower_bound(positions.begin(), positions.end(), start); pos != positions.end(); ++pos) {
+		if (StringCompKey(nameAt(*pos), key)) {
+			return *pos;
+		}
+	}
+	return TableMgr::npos;
+}
+
 p2DAImporter::p2DAImporter() noexcept
 {
 	colNames.reserve(10);
@@ -104,6 +140,14 @@ bool p2DAImporter::Open(DataStream* str)
 
 	delete str;
 	assert(rows.size() < std::numeric_limits<index_t>::max());
+
+	for (index_t i = 0; i < colNames.size(); i++) {
+		AddToIndex(colIndex, colNames[i], i);
+	}
+	for (index_t i = 0; i < rowNames.size(); i++) {
+		AddToIndex(rowIndex, rowNames[i], i);
+		maxColumns = std::max(maxColumns, static_cast<index_t>(rows[i].size()));
+	}
 	return true;
 }
 
@@ -149,22 +193,16 @@ const std::string& p2DAImporter::QueryDefault() const
 
 p2DAImporter::index_t p2DAImporter::GetRowIndex(const key_t& key) const
 {
-	for (index_t index = 0; index < rowNames.size(); index++) {
-		if (StringCompKey(rowNames[index], key)) {
-			return index;
-		}
-	}
-	return npos;
+	return FindInIndex(rowIndex, key, 0, [this](index_t i) -> const std::string& {
+		return rowNames[i];
+	});
 }
 
 p2DAImporter::index_t p2DAImporter::GetColumnIndex(const key_t& key) const
 {
-	for (index_t index = 0; index < colNames.size(); index++) {
-		if (StringCompKey(colNames[index], key)) {
-			return index;
-		}
-	}
-	return npos;
+	return FindInIndex(colIndex, key, 0, [this](index_t i) -> const std::string& {
+		return colNames[i];
+	});
 }
 
 const static std::string blank;
@@ -184,27 +222,64 @@ const std::string& p2DAImporter::GetRowName(index_t index) const
 	return blank;
 }
 
-p2DAImporter::index_t p2DAImporter::FindTableValue(index_t col, long val, index_t start) const
+// tables are only searched from the main thread, so building it lazily is fine
+const p2DAImporter::ValueIndex& p2DAImporter::GetValueIndex(index_t col) const
 {
+	assert(col < maxColumns);
+	if (valueIndexes.size() <= col) {
+		valueIndexes.resize(maxColumns);
+	}
+
+	ValueIndex& index = valueIndexes[col];
+	if (index.built) {
+		return index;
+	}
+
 	index_t max = GetRowCount();
-	for (index_t row = start; row < max; row++) {
-		const std::string& ret = QueryField( row, col );
+	for (index_t row = 0; row < max; row++) {
+		const std::string& ret = QueryField(row, col);
 		long Value;
-		if (valid_signednumber(ret.c_str(), Value) && (Value == val))
-			return row;
+		if (valid_signednumber(ret.c_str(), Value)) {
+			index.numbers[Value].push_back(row);
+		}
+		AddToIndex(index.strings, ret, row);
 	}
-	return npos;
+	index.built = true;
+	return index;
+}
+
+p2DAImporter::index_t p2DAImporter::FindTableValue(index_t col, long val, index_t start) const
+{
+	if (start >= GetRowCount()) {
+		return npos;
+	}
+	if (col >= maxColumns) {
+		// every row has the default here
+		long Value;
+		return valid_signednumber(defVal.c_str(), Value) && Value == val ? start : npos;
+	}
+
+	const ValueIndex& index = GetValueIndex(col);
+	auto it = index.numbers.find(val);
+	if (it == index.numbers.end()) {
+		return npos;
+	}
+	auto row = std::lower_bound(it->second.begin(), it->second.end(), start);
+	return row == it->second.end() ? npos : *row;
 }
 
 p2DAImporter::index_t p2DAImporter::FindTableValue(index_t col, const key_t& val, index_t start) const
 {
-	index_t max = GetRowCount();
-	for (index_t row = start; row < max; row++) {
-		const std::string& ret = QueryField( row, col );
-		if (StringCompKey(ret, val))
-			return row;
+	if (start >= GetRowCount()) {
+		return npos;
 	}
-	return npos;
+	if (col >= maxColumns) {
+		return StringCompKey(defVal, val) ? start : npos;
+	}
+
+	return FindInIndex(GetValueIndex(col).strings, val, start, [this, col](index_t row) -> const std::string& {
+		return QueryField(row, col);
+	});
 }
 
 p2DAImporter::index_t p2DAImporter::FindTableValue(const key_t& col, long val, index_t start) const
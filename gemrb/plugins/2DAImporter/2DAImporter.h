@@ -26,6 +26,7 @@
 #include "globals.h"
 
 #include <cstring>
+#include <unordered_map>
 #include <vector>
 
 namespace GemRB {
@@ -39,6 +40,22 @@ private:
 	std::vector<cell_t> rowNames;
 	std::vector<row_t> rows;
 	std::string defVal;
+	index_t maxColumns = 0;
+
+	// case insensitive hashes of the names to their positions, in order
+	using name_index_t = std::unordered_map<size_t, std::vector<index_t>>;
+	name_index_t rowIndex;
+	name_index_t colIndex;
+
+	// per column lookup of the values, built on the first search in it
+	struct ValueIndex {
+		bool built = false;
+		std::unordered_map<long, std::vector<index_t>> numbers;
+		name_index_t strings;
+	};
+	mutable std::vector<ValueIndex> valueIndexes;
+
+	const ValueIndex& GetValueIndex(index_t col) const;
 public:
 	p2DAImporter() noexcept;
 
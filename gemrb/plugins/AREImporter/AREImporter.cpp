@@ -365,7 +365,7 @@ bool AREImporter::ChangeMap(Map *map, bool day_or_night)
 	if (day_or_night) {
 		TmpResRef = map->WEDResRef;
 	} else {
-		TmpResRef.Format("{.7:}N", map->WEDResRef);
+		TmpResRef.Format("{:.7}N", map->WEDResRef);
 	}
 	PluginHolder<TileMapMgr> tmm = MakePluginHolder<TileMapMgr>(IE_WED_CLASS_ID);
 	DataStream* wedfile = gamedata->GetResource( TmpResRef, IE_WED_CLASS_ID );
@@ -473,6 +473,36 @@ static Ambient* SetupMainAmbients(Map *map, bool day_or_night) {
 	return ambi;
 }
 
+ResourcePreloader::Ticket AREImporter::PreloadResources(bool day_or_night, int priority) const
+{
+	if (!(AreaFlags & AT_EXTENDED_NIGHT))
+		day_or_night = true;
+
+	// the same set GetMap and MakeTileProps load, the tilesets being the bulk of it
+	ResourcePreloader::Ticket ticket = ResourcePreloader::NoTicket;
+	ticket = gamedata->Preload(ticket, WEDResRef, IE_WED_CLASS_ID, priority);
+	ticket = gamedata->Preload(ticket, WEDResRef, IE_TIS_CLASS_ID, priority);
+
+	ResRef TmpResRef;
+	if (!day_or_night) {
+		TmpResRef.Format("{:.7}N", WEDResRef);
+		ticket = gamedata->Preload(ticket, TmpResRef, &ImageMgr::ID, priority);
+	}
+	ticket = gamedata->Preload(ticket, WEDResRef, &ImageMgr::ID, priority);
+
+	if (day_or_night) {
+		TmpResRef.Format("{:.6}LM", WEDResRef);
+	} else {
+		TmpResRef.Format("{:.6}LN", WEDResRef);
+	}
+	ticket = gamedata->Preload(ticket, TmpResRef, &ImageMgr::ID, priority);
+	TmpResRef.Format("{:.6}SR", WEDResRef);
+	ticket = gamedata->Preload(ticket, TmpResRef, &ImageMgr::ID, priority);
+	TmpResRef.Format("{:.6}HT", WEDResRef);
+	ticket = gamedata->Preload(ticket, TmpResRef, &ImageMgr::ID, priority);
+	return ticket;
+}
+
 Map* AREImporter::GetMap(const ResRef& resRef, bool day_or_night)
 {
 	// if this area does not have extended night, force it to day mode
@@ -494,7 +524,7 @@ Map* AREImporter::GetMap(const ResRef& resRef, bool day_or_night)
 	if (day_or_night) {
 		TmpResRef = WEDResRef;
 	} else {
-		TmpResRef.Format("{.7:}N", WEDResRef);
+		TmpResRef.Format("{:.7}N", WEDResRef);
 	}
 
 	// Small map for MapControl
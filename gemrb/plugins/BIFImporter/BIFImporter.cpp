@@ -35,12 +35,6 @@ using namespace GemRB;
 BIFImporter::~BIFImporter(void)
 {
 	delete stream;
-	if (fentries) {
-		delete[] fentries;
-	}
-	if (tentries) {
-		delete[] tentries;
-	}
 }
 
 DataStream* BIFImporter::DecompressBIFC(DataStream* compressed, const char* path)
@@ -160,20 +154,16 @@ int BIFImporter::OpenArchive(const char* path)
 DataStream* BIFImporter::GetStream(unsigned long Resource, unsigned long Type)
 {
 	if (Type == IE_TIS_CLASS_ID) {
-		unsigned int srcResLoc = Resource & 0xFC000;
-		for (unsigned int i = 0; i < tentcount; i++) {
-			if (( tentries[i].resLocator & 0xFC000 ) == srcResLoc) {
-				return SliceStream( stream, tentries[i].dataOffset,
-							tentries[i].tileSize * tentries[i].tilesCount );
-			}
+		const auto it = tileIndex.find(Resource & 0xFC000);
+		if (it != tileIndex.end()) {
+			const TileEntry& entry = tentries[it->second];
+			return SliceStream(stream, entry.dataOffset, entry.tileSize * entry.tilesCount);
 		}
 	} else {
-		ieDword srcResLoc = Resource & 0x3FFF;
-		for (ieDword i = 0; i < fentcount; i++) {
-			if (( fentries[i].resLocator & 0x3FFF ) == srcResLoc) {
-				return SliceStream( stream, fentries[i].dataOffset,
-							fentries[i].fileSize );
-			}
+		const auto it = fileIndex.find(Resource & 0x3FFF);
+		if (it != fileIndex.end()) {
+			const FileEntry& entry = fentries[it->second];
+			return SliceStream(stream, entry.dataOffset, entry.fileSize);
 		}
 	}
 	return NULL;
@@ -182,17 +172,18 @@ DataStream* BIFImporter::GetStream(unsigned long Resource, unsigned long Type)
 int BIFImporter::ReadBIF()
 {
 	ieDword foffset;
+	ieDword fentcount;
+	ieDword tentcount;
 	stream->ReadDword(fentcount);
 	stream->ReadDword(tentcount);
 	stream->ReadDword(foffset);
 	stream->Seek( foffset, GEM_STREAM_START );
-	fentries = new FileEntry[fentcount];
-	tentries = new TileEntry[tentcount];
-	if (!fentries || !tentries) {
-		delete fentries;
-		delete tentries;
-		return GEM_ERROR;
-	}
+	fentries.resize(fentcount);
+	tentries.resize(tentcount);
+	fileIndex.clear();
+	fileIndex.reserve(fentcount);
+	tileIndex.clear();
+	tileIndex.reserve(tentcount);
 
 	for (unsigned int i = 0; i < fentcount; i++) {
 		stream->ReadDword(fentries[i].resLocator);
@@ -200,6 +191,8 @@ int BIFImporter::ReadBIF()
 		stream->ReadDword(fentries[i].fileSize);
 		stream->ReadWord(fentries[i].type);
 		stream->ReadWord(fentries[i].u1);
+		// emplace keeps the first match, like the old linear search did
+		fileIndex.emplace(fentries[i].resLocator & 0x3FFF, i);
 	}
 	for (unsigned int i = 0; i < tentcount; i++) {
 		stream->ReadDword(tentries[i].resLocator);
@@ -208,6 +201,7 @@ int BIFImporter::ReadBIF()
 		stream->ReadDword(tentries[i].tileSize);
 		stream->ReadWord(tentries[i].type);
 		stream->ReadWord(tentries[i].u1);
+		tileIndex.emplace(tentries[i].resLocator & 0xFC000, i);
 	}
 	return GEM_OK;
 }
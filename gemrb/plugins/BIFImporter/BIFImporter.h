@@ -27,6 +27,9 @@
 
 #include "Streams/DataStream.h"
 
+#include <unordered_map>
+#include <vector>
+
 namespace GemRB {
 
 struct FileEntry {
@@ -48,10 +51,11 @@ struct TileEntry {
 
 class BIFImporter : public IndexedArchive {
 private:
-	FileEntry* fentries = nullptr;
-	TileEntry* tentries = nullptr;
-	ieDword fentcount = 0;
-	ieDword tentcount = 0;
+	std::vector<FileEntry> fentries;
+	std::vector<TileEntry> tentries;
+	// locator index -> position in the entry vectors
+	std::unordered_map<ieDword, size_t> fileIndex;
+	std::unordered_map<ieDword, size_t> tileIndex;
 	DataStream* stream = nullptr;
 public:
 	BIFImporter() noexcept = default;
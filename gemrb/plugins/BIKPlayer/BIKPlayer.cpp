@@ -46,6 +46,15 @@
 #include <cmath>
 #include <cstdio>
 
+// SSE2 is always there on x86-64, so is NEON on arm64
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BINK_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BINK_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
 using namespace GemRB;
 using namespace std::chrono;
 
@@ -189,6 +198,8 @@ bool BIKPlayer::Import(DataStream* str)
 			movieSize.w = header.width;
 			movieSize.h = header.height;
 			framePos = 0;
+			// quick hack, we should rather use the rational time base as ffmpeg
+			frame_wait = microseconds(v_timebase.num * 1000000 / v_timebase.den);
 			sound_init( core->GetAudioDrv()->CanPlay());
 			return video_init() == 0;
 		}
@@ -202,10 +213,6 @@ bool BIKPlayer::DecodeFrame(VideoBuffer& buf)
 		return false;
 	}
 
-	if (lastTime > seconds(0)) {
-		// quick hack, we should rather use the rational time base as ffmpeg
-		timer_wait(microseconds(v_timebase.num * 1000000 / v_timebase.den));
-	}
 	if(framePos >= header.framecount) {
 		return false;
 	}
@@ -222,10 +229,6 @@ bool BIKPlayer::DecodeFrame(VideoBuffer& buf)
 		//buggy frame, we stop immediately
 		return false;
 	}
-	if (lastTime == seconds(0)) {
-		timer_start();
-	}
-
 	return true;
 }
 
@@ -261,8 +264,7 @@ void BIKPlayer::freeAudioStream(int stream) const
 
 void BIKPlayer::queueBuffer(int stream, unsigned short bits, int channels, short* memory, int size, int samplerate) const
 {
-	if (stream > -1)
-		core->GetAudioDrv()->QueueBuffer(stream, bits, channels, memory, size, samplerate);
+	QueueAudio(stream, bits, channels, memory, size, samplerate);
 }
 
 
@@ -1090,8 +1092,14 @@ static void get_pixels(DCTELEM *block, const uint8_t *pixels, int line_size)
 
 static void put_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int line_size)
 {
-	/* read the pixels */
 	for (int i = 0; i < 8; i++) {
+#if BINK_SIMD_SSE2
+		// keep only the low byte, like the scalar assignment
+		__m128i row = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), _mm_set1_epi16(0xFF));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(pixels), _mm_packus_epi16(row, row));
+#elif BINK_SIMD_NEON
+		vst1_u8(pixels, vmovn_u16(vreinterpretq_u16_s16(vld1q_s16(block))));
+#else
 		pixels[0] = block[0];
 		pixels[1] = block[1];
 		pixels[2] = block[2];
@@ -1100,6 +1108,7 @@ static void put_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int lin
 		pixels[5] = block[5];
 		pixels[6] = block[6];
 		pixels[7] = block[7];
+#endif
 		pixels += line_size;
 		block += 8;
 	}
@@ -1107,8 +1116,16 @@ static void put_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int lin
 
 static void add_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int line_size)
 {
-	/* read the pixels */
 	for (int i = 0; i < 8; i++) {
+#if BINK_SIMD_SSE2
+		__m128i row = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels)), _mm_setzero_si128());
+		row = _mm_add_epi16(row, _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)));
+		row = _mm_and_si128(row, _mm_set1_epi16(0xFF));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(pixels), _mm_packus_epi16(row, row));
+#elif BINK_SIMD_NEON
+		uint16x8_t row = vaddq_u16(vmovl_u8(vld1_u8(pixels)), vreinterpretq_u16_s16(vld1q_s16(block)));
+		vst1_u8(pixels, vmovn_u16(row));
+#else
 		pixels[0] += block[0];
 		pixels[1] += block[1];
 		pixels[2] += block[2];
@@ -1117,6 +1134,7 @@ static void add_pixels_nonclamped(const DCTELEM *block, uint8_t *pixels, int lin
 		pixels[5] += block[5];
 		pixels[6] += block[6];
 		pixels[7] += block[7];
+#endif
 		pixels += line_size;
 		block += 8;
 	}
@@ -1130,6 +1148,155 @@ static inline void copy_block(DCTELEM block[64], const uint8_t *src, uint8_t *ds
 
 #define clear_block(block) memset((block), 0, sizeof(DCTELEM) * 64)
 
+#if BINK_SIMD_SSE2 || BINK_SIMD_NEON
+// four lanes of 32 bit intermediates, so the results match the scalar version exactly
+#if BINK_SIMD_SSE2
+using idct_vec = __m128i;
+
+static inline idct_vec vec_add(idct_vec a, idct_vec b) { return _mm_add_epi32(a, b); }
+static inline idct_vec vec_sub(idct_vec a, idct_vec b) { return _mm_sub_epi32(a, b); }
+
+// (a * c) >> 11; SSE2 has no 32 bit multiplication, so the even and odd lanes go separately
+static inline idct_vec vec_mul11(idct_vec a, int c)
+{
+	__m128i k = _mm_set1_epi32(c);
+	__m128i even = _mm_mul_epu32(a, k);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), k);
+	__m128i prod = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+									  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	return _mm_srai_epi32(prod, 11);
+}
+
+static inline void vec_transpose(idct_vec v[4])
+{
+	__m128i t0 = _mm_unpacklo_epi32(v[0], v[1]);
+	__m128i t1 = _mm_unpacklo_epi32(v[2], v[3]);
+	__m128i t2 = _mm_unpackhi_epi32(v[0], v[1]);
+	__m128i t3 = _mm_unpackhi_epi32(v[2], v[3]);
+	v[0] = _mm_unpacklo_epi64(t0, t1);
+	v[1] = _mm_unpackhi_epi64(t0, t1);
+	v[2] = _mm_unpacklo_epi64(t2, t3);
+	v[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+static inline void vec_load(const DCTELEM *row, idct_vec& lo, idct_vec& hi)
+{
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+	lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+	hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+}
+
+// rounds and narrows; wrapping instead of saturating, like the scalar assignment
+static inline void vec_store(DCTELEM *row, idct_vec lo, idct_vec hi)
+{
+	__m128i bias = _mm_set1_epi32(0x7F);
+	lo = _mm_srai_epi32(_mm_add_epi32(lo, bias), 8);
+	hi = _mm_srai_epi32(_mm_add_epi32(hi, bias), 8);
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(row), _mm_packs_epi32(lo, hi));
+}
+#else
+using idct_vec = int32x4_t;
+
+static inline idct_vec vec_add(idct_vec a, idct_vec b) { return vaddq_s32(a, b); }
+static inline idct_vec vec_sub(idct_vec a, idct_vec b) { return vsubq_s32(a, b); }
+static inline idct_vec vec_mul11(idct_vec a, int c) { return vshrq_n_s32(vmulq_n_s32(a, c), 11); }
+
+static inline void vec_transpose(idct_vec v[4])
+{
+	int32x4x2_t t01 = vtrnq_s32(v[0], v[1]);
+	int32x4x2_t t23 = vtrnq_s32(v[2], v[3]);
+	v[0] = vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0]));
+	v[1] = vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1]));
+	v[2] = vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0]));
+	v[3] = vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1]));
+}
+
+static inline void vec_load(const DCTELEM *row, idct_vec& lo, idct_vec& hi)
+{
+	int16x8_t v = vld1q_s16(row);
+	lo = vmovl_s16(vget_low_s16(v));
+	hi = vmovl_s16(vget_high_s16(v));
+}
+
+static inline void vec_store(DCTELEM *row, idct_vec lo, idct_vec hi)
+{
+	int32x4_t bias = vdupq_n_s32(0x7F);
+	lo = vshrq_n_s32(vaddq_s32(lo, bias), 8);
+	hi = vshrq_n_s32(vaddq_s32(hi, bias), 8);
+	vst1q_s16(row, vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)));
+}
+#endif
+
+// one pass of the scalar version below, over four columns or rows at once
+static inline void bink_idct_1d(idct_vec v[8])
+{
+	idct_vec t0 = vec_add(v[0], v[4]);
+	idct_vec t1 = vec_sub(v[0], v[4]);
+	idct_vec t2 = vec_add(v[2], v[6]);
+	idct_vec t3 = vec_sub(v[2], v[6]);
+	t3 = vec_sub(vec_mul11(t3, 0xB50), t2);
+
+	idct_vec t4 = vec_sub(t0, t2);
+	idct_vec t5 = vec_add(t0, t2);
+	idct_vec t6 = vec_add(t1, t3);
+	idct_vec t7 = vec_sub(t1, t3);
+
+	t0 = vec_add(v[5], v[3]);
+	t1 = vec_sub(v[5], v[3]);
+	t2 = vec_add(v[1], v[7]);
+	t3 = vec_sub(v[1], v[7]);
+
+	idct_vec t8 = vec_add(t2, t0);
+	idct_vec t9 = vec_mul11(vec_add(t3, t1), 0xEC8);
+	idct_vec tA = vec_sub(vec_add(vec_mul11(t1, -0x14E8), t9), t8);
+	idct_vec tB = vec_sub(vec_mul11(vec_sub(t2, t0), 0xB50), tA);
+	idct_vec tC = vec_sub(vec_add(vec_mul11(t3, 0x8A9), tB), t9);
+
+	v[0] = vec_add(t5, t8);
+	v[7] = vec_sub(t5, t8);
+	v[1] = vec_add(t6, tA);
+	v[6] = vec_sub(t6, tA);
+	v[2] = vec_add(t7, tB);
+	v[5] = vec_sub(t7, tB);
+	v[4] = vec_add(t4, tC);
+	v[3] = vec_sub(t4, tC);
+}
+
+// lo holds the left and hi the right half of each row
+static inline void bink_transpose(idct_vec lo[8], idct_vec hi[8])
+{
+	vec_transpose(lo);
+	vec_transpose(lo + 4);
+	vec_transpose(hi);
+	vec_transpose(hi + 4);
+	for (int i = 0; i < 4; i++) {
+		std::swap(lo[i + 4], hi[i]);
+	}
+}
+
+static void bink_idct(DCTELEM *block)
+{
+	idct_vec lo[8];
+	idct_vec hi[8];
+
+	for (int i = 0; i < 8; i++) {
+		vec_load(block + i * 8, lo[i], hi[i]);
+	}
+	// columns
+	bink_idct_1d(lo);
+	bink_idct_1d(hi);
+	// rows
+	bink_transpose(lo, hi);
+	bink_idct_1d(lo);
+	bink_idct_1d(hi);
+	bink_transpose(lo, hi);
+	for (int i = 0; i < 8; i++) {
+		vec_store(block + i * 8, lo[i], hi[i]);
+	}
+}
+#else
 //This replaces the j_rev_dct module
 static void bink_idct(DCTELEM *block)
 {
@@ -1206,6 +1373,7 @@ static void bink_idct(DCTELEM *block)
 		block[i+3] = (t4 - tC + 0x7F) >> 8;
 	}
 }
+#endif
 
 static void idct_put(uint8_t *dest, int line_size, DCTELEM *block)
 {
@@ -1439,19 +1607,14 @@ int BIKPlayer::DecodeVideoFrame(void *data, int data_size, VideoBuffer& buf)
 		v_gb.get_bits_align32();
 	}
 
-	if (video_frameskip) {
-		video_frameskip--;
-		video_skippedframes++;
-	} else {
-		const Size& bufsize = buf.Size();
-		int dest_x = unsigned(bufsize.w - header.width) >> 1;
-		int dest_y = unsigned(bufsize.h - header.height) >> 1;
+	const Size& bufsize = buf.Size();
+	int dest_x = unsigned(bufsize.w - header.width) >> 1;
+	int dest_y = unsigned(bufsize.h - header.height) >> 1;
 
-		buf.CopyPixels(Region(dest_x, dest_y, header.width, header.height),
-					   c_pic->data[0], &c_pic->linesize[0], // Y
-					   c_pic->data[1], &c_pic->linesize[1], // U
-					   c_pic->data[2], &c_pic->linesize[2]);// V
-	}
+	buf.CopyPixels(Region(dest_x, dest_y, header.width, header.height),
+				   c_pic->data[0], &c_pic->linesize[0], // Y
+				   c_pic->data[1], &c_pic->linesize[1], // U
+				   c_pic->data[2], &c_pic->linesize[2]);// V
 
 	std::swap(c_pic, c_last);
 	return 0;
@@ -40,6 +40,7 @@
 #include "MusicMgr.h"
 #include "Palette.h"
 #include "PalettedImageMgr.h"
+#include "Profiler.h"
 #include "ResourceDesc.h"
 #include "RNG.h"
 #include "SaveGameIterator.h"
@@ -606,6 +607,51 @@ static PyObject* GemRB_EnableCheatKeys(PyObject * /*self*/, PyObject* args)
 	Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR( GemRB_EnableProfiler__doc,
+"===== EnableProfiler =====\n\
+\n\
+**Prototype:** GemRB.EnableProfiler (flag)\n\
+\n\
+**Description:** Starts or stops recording the main loop timeline. \n\
+Already recorded zones are kept until they get overwritten.\n\
+\n\
+**Parameters:** flag - boolean\n\
+\n\
+**Return value:** N/A\n\
+\n\
+**See also:** [DumpProfile](DumpProfile.md)"
+);
+
+static PyObject* GemRB_EnableProfiler(PyObject * /*self*/, PyObject* args)
+{
+	int flag = 0;
+	PARSE_ARGS(args, "i", &flag);
+	Profiler::SetEnabled(flag);
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR( GemRB_DumpProfile__doc,
+"===== DumpProfile =====\n\
+\n\
+**Prototype:** GemRB.DumpProfile (filename)\n\
+\n\
+**Description:** Writes the recorded timeline in the Chrome trace format, \n\
+which can be opened in chrome://tracing or Perfetto.\n\
+\n\
+**Parameters:** filename - path of the json file to create\n\
+\n\
+**Return value:** boolean, true on success\n\
+\n\
+**See also:** [EnableProfiler](EnableProfiler.md)"
+);
+
+static PyObject* GemRB_DumpProfile(PyObject * /*self*/, PyObject* args)
+{
+	char* filename = nullptr;
+	PARSE_ARGS(args, "s", &filename);
+	return PyBool_FromLong(Profiler::Dump(filename));
+}
+
 PyDoc_STRVAR( GemRB_LoadTable__doc,
 "===== LoadTable =====\n\
 \n\
@@ -13149,7 +13195,9 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(DragItem, METH_VARARGS),
 	METHOD(DropDraggedItem, METH_VARARGS),
 	METHOD(DumpActor, METH_VARARGS),
+	METHOD(DumpProfile, METH_VARARGS),
 	METHOD(EnableCheatKeys, METH_VARARGS),
+	METHOD(EnableProfiler, METH_VARARGS),
 	METHOD(EndCutSceneMode, METH_NOARGS),
 	METHOD(EnterGame, METH_NOARGS),
 	METHOD(EnterStore, METH_VARARGS),
@@ -13694,6 +13742,7 @@ PyObject *GUIScript::RunFunction(const char* moduleName, const char* functionNam
 		Py_DECREF(pyModule);
 		return NULL;
 	}
+	ProfileZone zone("RunFunction", StringView(functionName));
 	PyObject *pValue = PyObject_CallObject( pFunc, pArgs );
 	if (pValue == NULL) {
 		if (PyErr_Occurred()) {
@@ -24,6 +24,7 @@
 
 #include "globals.h"
 
+#include <algorithm>
 #include <cstring>
 
 using namespace GemRB;
@@ -62,28 +63,39 @@ bool IDSImporter::Open(DataStream* str)
 		}
 	}
 
+	for (int i = 0; i < static_cast<int>(pairs.size()); ++i) {
+		const std::string& name = pairs[i].str;
+		stringIndex.emplace(name, i);
+		size_t paren = name.find('(');
+		if (paren != std::string::npos) {
+			functionIndex[name.substr(0, paren + 1)] = i;
+		}
+		auto range = valueIndex.emplace(pairs[i].val, std::make_pair(i, i));
+		range.first->second.second = i;
+	}
+
 	delete str;
 	return true;
 }
 
 int IDSImporter::GetValue(StringView txt) const
 {
-	for (const auto& pair : pairs) {
-		if (stricmp(pair.str.c_str(), txt.c_str()) == 0) {
-			return pair.val;
-		}
+	std::string key(txt.c_str(), txt.length());
+	StringToLower(key);
+	auto it = stringIndex.find(key);
+	if (it == stringIndex.end()) {
+		return -1;
 	}
-	return -1;
+	return pairs[it->second].val;
 }
 
 const std::string& IDSImporter::GetValue(int val) const
 {
-	for (const auto& pair : pairs) {
-		if (pair.val == val) {
-			return pair.str;
-		}
+	auto it = valueIndex.find(val);
+	if (it == valueIndex.end()) {
+		return blank;
 	}
-	return blank;
+	return pairs[it->second.first].str;
 }
 
 const std::string& IDSImporter::GetStringIndex(size_t Index) const
@@ -104,6 +116,15 @@ int IDSImporter::GetValueIndex(size_t Index) const
 
 int IDSImporter::FindString(StringView str) const
 {
+	// the script parser always looks for a function name with its parenthesis
+	size_t paren = std::find(str.begin(), str.end(), '(') - str.begin();
+	if (paren + 1 == str.length()) {
+		std::string key(str.c_str(), str.length());
+		StringToLower(key);
+		auto it = functionIndex.find(key);
+		return it == functionIndex.end() ? -1 : it->second;
+	}
+
 	int i = static_cast<int>(pairs.size());
 	while(i--) {
 		if (strnicmp(pairs[i].str.c_str(), str.c_str(), str.length()) == 0) {
@@ -115,13 +136,11 @@ int IDSImporter::FindString(StringView str) const
 
 int IDSImporter::FindValue(int val) const
 {
-	int i = static_cast<int>(pairs.size());
-	while(i--) {
-		if(pairs[i].val==val) {
-			return i;
-		}
+	auto it = valueIndex.find(val);
+	if (it == valueIndex.end()) {
+		return -1;
 	}
-	return -1;
+	return it->second.second;
 }
 
 int IDSImporter::GetHighestValue() const
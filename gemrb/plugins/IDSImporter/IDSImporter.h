@@ -24,6 +24,7 @@
 #include "SymbolMgr.h"
 #include "Strings/StringView.h"
 
+#include <unordered_map>
 #include <vector>
 
 namespace GemRB {
@@ -40,6 +41,13 @@ private:
 	};
 
 	std::vector<Pair> pairs;
+	// the lookups used to be linear scans, but the script parser does a lot of them
+	// first index of each (lowercase) string
+	std::unordered_map<std::string, int> stringIndex;
+	// last index of each function name, including the opening parenthesis
+	std::unordered_map<std::string, int> functionIndex;
+	// first and last index of each value
+	std::unordered_map<int, std::pair<int, int>> valueIndex;
 
 public:
 	IDSImporter() noexcept = default;
@@ -190,6 +190,36 @@ bool KEYImporter::HasResource(StringView resname, const ResourceDesc &type)
 	return HasResource(resname, type.GetKeyType());
 }
 
+IndexedArchive *KEYImporter::GetArchive(unsigned int bifnum)
+{
+	if (bifnum >= biffiles.size()) {
+		Log(ERROR, "KEYImporter", "Invalid bif index {}!", bifnum);
+		return NULL;
+	}
+
+	BIFEntry &entry = biffiles[bifnum];
+	if (entry.archive) {
+		return entry.archive.get();
+	}
+
+	if (!entry.found) {
+		Log(ERROR, "KEYImporter", "Cannot find {}... Resource unavailable.",
+				entry.name);
+		return NULL;
+	}
+
+	// reopening and reparsing the bif on every request is very costly,
+	// so keep the archive and its entry index around for the session
+	PluginHolder<IndexedArchive> ai = MakePluginHolder<IndexedArchive>(IE_BIF_CLASS_ID);
+	if (ai->OpenArchive(entry.path) == GEM_ERROR) {
+		Log(ERROR, "KEYImporter", "Cannot open archive {}", entry.path);
+		return NULL;
+	}
+
+	entry.archive = std::move(ai);
+	return entry.archive.get();
+}
+
 DataStream* KEYImporter::GetStream(const ResRef& resname, ieWord type)
 {
 	if (type == 0)
@@ -200,16 +230,8 @@ DataStream* KEYImporter::GetStream(const ResRef& resname, ieWord type)
 		return 0;
 
 	unsigned int bifnum = ( *ResLocator & 0xFFF00000 ) >> 20;
-
-	if (!biffiles[bifnum].found) {
-		Log(ERROR, "KEYImporter", "Cannot find {}... Resource unavailable.",
-				biffiles[bifnum].name.c_str());
-		return NULL;
-	}
-
-	PluginHolder<IndexedArchive> ai = MakePluginHolder<IndexedArchive>(IE_BIF_CLASS_ID);
-	if (ai->OpenArchive( biffiles[bifnum].path ) == GEM_ERROR) {
-		Log(ERROR, "KEYImporter", "Cannot open archive {}", biffiles[bifnum].path);
+	IndexedArchive *ai = GetArchive(bifnum);
+	if (!ai) {
 		return NULL;
 	}
 
@@ -41,13 +41,8 @@ struct BIFEntry {
 	char path[_MAX_PATH];
 	int cd;
 	bool found;
-};
-
-struct KEYCache {
-	KEYCache() { bifnum = 0xffffffff; }
-
-	unsigned int bifnum;
-	PluginHolder<IndexedArchive> plugin;
+	// opened lazily on first access and kept for the whole session
+	PluginHolder<IndexedArchive> archive;
 };
 
 // the key for this specific hashmap
@@ -132,6 +127,8 @@ private:
 
 	/** Gets the stream assoicated to a RESKey */
 	DataStream *GetStream(const ResRef&, ieWord type);
+	/** Returns the (cached) opened archive for a bif index */
+	IndexedArchive *GetArchive(unsigned int bifnum);
 public:
 	bool Open(const char *file, const char *desc) override;
 	/* predicts the availability of a resource */
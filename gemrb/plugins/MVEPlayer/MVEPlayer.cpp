@@ -120,8 +120,7 @@ void MVEPlay::queueBuffer(int stream, unsigned short bits,
 			int channels, short* memory,
 			int size, int samplerate) const
 {
-	if (stream > -1)
-		core->GetAudioDrv()->QueueBuffer(stream, bits, channels, memory, size, samplerate) ;
+	QueueAudio(stream, bits, channels, memory, size, samplerate);
 }
 
 
@@ -0,0 +1,108 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "NullVideo.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using namespace GemRB;
+
+static int BytesPerPixel(Video::BufferFormat fmt)
+{
+	switch (fmt) {
+		case Video::BufferFormat::RGBPAL8:
+		case Video::BufferFormat::YV12:
+			return 1;
+		case Video::BufferFormat::RGB555:
+			return 2;
+		default:
+			return 4;
+	}
+}
+
+NullVideoBuffer::NullVideoBuffer(const Region& r, Video::BufferFormat fmt)
+: VideoBuffer(r), bytesPerPixel(BytesPerPixel(fmt)), pixels(r.w * r.h * bytesPerPixel)
+{}
+
+void NullVideoBuffer::Clear(const Region& rgn)
+{
+	Region clipped = rgn.Intersect(Region(Point(), rect.size));
+	if (clipped.w <= 0 || clipped.h <= 0) return;
+
+	for (int y = clipped.y; y < clipped.y + clipped.h; ++y) {
+		uint8_t* row = &pixels[(y * rect.w + clipped.x) * bytesPerPixel];
+		memset(row, 0, clipped.w * bytesPerPixel);
+	}
+}
+
+void NullVideoBuffer::CopyPixels(const Region& bufDest, const void* pixelBuf, const int* pitch, ...)
+{
+	Region clipped = bufDest.Intersect(Region(Point(), rect.size));
+	if (clipped.w <= 0 || clipped.h <= 0) return;
+
+	int srcPitch = pitch ? *pitch : bufDest.w * bytesPerPixel;
+	const uint8_t* src = static_cast<const uint8_t*>(pixelBuf);
+	src += (clipped.y - bufDest.y) * srcPitch + (clipped.x - bufDest.x) * bytesPerPixel;
+
+	for (int y = clipped.y; y < clipped.y + clipped.h; ++y, src += srcPitch) {
+		uint8_t* row = &pixels[(y * rect.w + clipped.x) * bytesPerPixel];
+		memcpy(row, src, clipped.w * bytesPerPixel);
+	}
+}
+
+bool NullVideo::SetFullscreenMode(bool set)
+{
+	fullscreen = set;
+	return true;
+}
+
+Holder<Sprite2D> NullVideo::CreateSprite(const Region& rgn, void* pixels, const PixelFormat& fmt)
+{
+	return MakeHolder<Sprite2D>(rgn, pixels, fmt);
+}
+
+Holder<Sprite2D> NullVideo::GetScreenshot(Region r, const VideoBufferPtr&)
+{
+	int width = r.w ? r.w : screenSize.w;
+	int height = r.h ? r.h : screenSize.h;
+
+	static const PixelFormat fmt(3, 0x00ff0000, 0x0000ff00, 0x000000ff, 0);
+	void* pixels = calloc(width * height, fmt.Bpp);
+	return MakeHolder<Sprite2D>(Region(0, 0, width, height), pixels, fmt);
+}
+
+void NullVideo::Wait(uint32_t ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+VideoBuffer* NullVideo::NewVideoBuffer(const Region& r, BufferFormat fmt)
+{
+	return new NullVideoBuffer(r, fmt);
+}
+
+#include "plugindef.h"
+
+GEMRB_PLUGIN(0x2F6C1A3E, "Null Video Driver")
+PLUGIN_DRIVER(NullVideo, "none")
+END_PLUGIN()
@@ -23,6 +23,7 @@
 #include "GameData.h"
 #include "Interface.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 
@@ -238,6 +239,7 @@ bool OpenALAudioDriver::Init(void)
 		num_streams, (num_streams < MAX_STREAMS ? " (Fewer than desired.)" : "" ));
 
 	musicThread = std::thread(&OpenALAudioDriver::MusicManager, this);
+	decodeThread = std::thread(&OpenALAudioDriver::DecoderLoop, this);
 
 	if (!InitEFX()) {
 		Log(MESSAGE, "OpenAL", "EFX not available.");
@@ -341,6 +343,14 @@ OpenALAudioDriver::~OpenALAudioDriver(void)
 	// AmigaOS4 should be built with -athread=native or this may not work
 	musicThread.join();
 
+	{
+		std::lock_guard<std::mutex> l(decodeMutex);
+		decodeQueue.clear();
+	}
+	decodeCond.notify_all();
+	decodeThread.join();
+	pendingDecodes.clear();
+
 	for(int i =0; i<num_streams; i++) {
 		streams[i].ForceClear();
 	}
@@ -371,16 +381,182 @@ OpenALAudioDriver::~OpenALAudioDriver(void)
 	delete ambim;
 }
 
-ALuint OpenALAudioDriver::loadSound(StringView ResRef, tick_t &time_length)
+// reads the whole sound into memory, safe to call from the decoder thread as it makes no AL calls
+void OpenALAudioDriver::ReadSound(SoundMgr& reader, DecodedSound& sound)
+{
+	sound.length = reader.get_length();
+	sound.channels = reader.get_channels();
+	sound.samplerate = reader.get_samplerate();
+	sound.samples.resize(sound.length);
+	//it is always reading the stuff into 16 bits
+	sound.samples.resize(reader.read_samples(sound.samples.data(), sound.length));
+}
+
+// AL error state is shared, so this must stay on the main thread like the other checked calls
+bool OpenALAudioDriver::UploadSound(const DecodedSound& sound, CacheEntry& entry) const
 {
 	ALuint Buffer = 0;
+	alGenBuffers(1, &Buffer);
+	if (checkALError("Unable to create sound buffer", ERROR)) {
+		return false;
+	}
+
+	//multiply always with 2 because it is in 16 bits
+	unsigned int cnt1 = sound.samples.size() * 2;
+	alBufferData(Buffer, GetFormatEnum(sound.channels, 16), sound.samples.data(), cnt1, sound.samplerate);
+
+	if (checkALError("Unable to fill buffer", ERROR)) {
+		alDeleteBuffers( 1, &Buffer );
+		checkALError("Error deleting buffer", WARNING);
+		return false;
+	}
+
+	entry.Buffer = Buffer;
+	//Sound Length in milliseconds
+	entry.Length = ((sound.length / sound.channels) * 1000) / sound.samplerate;
+	entry.Size = cnt1;
+	return true;
+}
+
+// decodes the whole sound into a new buffer right away
+bool OpenALAudioDriver::DecodeSound(SoundMgr& reader, CacheEntry& entry) const
+{
+	DecodedSound sound;
+	ReadSound(reader, sound);
+	return UploadSound(sound, entry);
+}
+
+void OpenALAudioDriver::AddToCache(StringView ResRef, CacheEntry* e)
+{
+	buffercache.SetAt(ResRef, (void*)e);
+	buffercacheBytes += e->Size;
+	//print("LoadSound: added %s to cache: %d. Cache size now %d", ResRef, e->Buffer, buffercache.GetCount());
+
+	// keep at least this buffer, even if it alone is over the budget
+	while (buffercacheBytes > BUFFER_CACHE_BYTES && buffercache.GetCount() > 1) {
+		if (!evictBuffer()) break;
+	}
+}
+
+// moves a prefetched sound into the cache, reading it here if the thread didn't get to it yet
+// returns false if it is still being read and we shouldn't wait for it
+// main thread only, since it uploads the buffer
+bool OpenALAudioDriver::FinishDecode(const ResRef& key, bool wait)
+{
+	std::unique_lock<std::mutex> l(decodeMutex);
+	auto it = pendingDecodes.find(key);
+	if (it == pendingDecodes.end()) {
+		return false;
+	}
+	std::shared_ptr<DecodeJob> job = it->second;
+
+	if (!job->started) {
+		// don't wait behind the whole queue, it's quicker to read it now
+		decodeQueue.erase(std::find(decodeQueue.begin(), decodeQueue.end(), job));
+		job->started = true;
+		l.unlock();
+		ReadSound(*job->reader, job->sound);
+		job->reader = nullptr;
+		l.lock();
+		job->done = true;
+	} else if (!job->done) {
+		if (!wait) return false;
+		decodeCond.wait(l, [&job]() { return job->done; });
+	}
+	pendingDecodes.erase(key);
+	l.unlock();
+
+	// the ambient thread may have loaded it on its own in the meantime
+	void* p;
+	if (buffercache.Lookup(key, p)) {
+		return true;
+	}
+	CacheEntry* entry = new CacheEntry;
+	if (UploadSound(job->sound, *entry)) {
+		AddToCache(key, entry);
+	} else {
+		delete entry;
+	}
+	return true;
+}
+
+// moves the finished prefetches into the cache, so they count against its budget
+// main thread only, like FinishDecode
+void OpenALAudioDriver::CollectDecodes()
+{
+	std::vector<ResRef> finished;
+	{
+		std::lock_guard<std::mutex> l(decodeMutex);
+		for (const auto& pending : pendingDecodes) {
+			if (pending.second->done) {
+				finished.push_back(pending.first);
+			}
+		}
+	}
+	for (const ResRef& key : finished) {
+		FinishDecode(key, false);
+	}
+}
+
+void OpenALAudioDriver::DecoderLoop()
+{
+	std::unique_lock<std::mutex> l(decodeMutex);
+	while (stayAlive) {
+		decodeCond.wait(l, [this]() { return !decodeQueue.empty() || !stayAlive; });
+		if (!stayAlive) break;
+
+		std::shared_ptr<DecodeJob> job = decodeQueue.front();
+		decodeQueue.pop_front();
+		job->started = true;
+		l.unlock();
+
+		DecodedSound sound;
+		ReadSound(*job->reader, sound);
+		job->reader = nullptr;
+
+		l.lock();
+		job->sound = std::move(sound);
+		job->done = true;
+		decodeCond.notify_all();
+	}
+}
+
+void OpenALAudioDriver::Prefetch(const std::vector<ResRef>& sounds)
+{
+	CollectDecodes();
+	for (const ResRef& sound : sounds) {
+		// just refresh the position of anything already decoded, so it doesn't get evicted first
+		if (sound.IsEmpty() || buffercache.Touch(sound)) continue;
+		{
+			std::lock_guard<std::mutex> l(decodeMutex);
+			if (pendingDecodes.count(sound)) continue;
+		}
+
+		// opening the resource touches shared state, so only the reading itself is deferred
+		auto job = std::make_shared<DecodeJob>();
+		job->reader = GetResourceHolder<SoundMgr>(sound);
+		if (!job->reader) continue;
 
+		std::lock_guard<std::mutex> l(decodeMutex);
+		pendingDecodes.emplace(sound, job);
+		decodeQueue.push_back(std::move(job));
+	}
+	decodeCond.notify_one();
+}
+
+// the ambient thread passes mainThread = false and skips the prefetches,
+// they get moved into the cache by the next call from the main thread instead
+ALuint OpenALAudioDriver::loadSound(StringView ResRef, tick_t &time_length, bool mainThread)
+{
 	CacheEntry *e;
 	void* p;
 
 	if (ResRef.empty()) {
 		return 0;
 	}
+	if (mainThread) {
+		CollectDecodes();
+	}
 	
 	LRUCache::key_t key(ResRef);
 	if(buffercache.Lookup(key, p))
@@ -390,48 +566,27 @@ ALuint OpenALAudioDriver::loadSound(StringView ResRef, tick_t &time_length)
 		return e->Buffer;
 	}
 
-	//no cache entry...
-	alGenBuffers(1, &Buffer);
-	if (checkALError("Unable to create sound buffer", ERROR)) {
-		return 0;
+	// the length is needed right away, so wait for a prefetch in progress
+	if (mainThread && FinishDecode(GemRB::ResRef(ResRef), true) && buffercache.Lookup(key, p)) {
+		e = (CacheEntry*) p;
+		time_length = e->Length;
+		return e->Buffer;
 	}
 
+	//no cache entry...
 	ResourceHolder<SoundMgr> acm = GetResourceHolder<SoundMgr>(ResRef);
 	if (!acm) {
-		alDeleteBuffers( 1, &Buffer );
-		checkALError("Unable to delete buffer!", ERROR);
-		return 0;
-	}
-	int cnt = acm->get_length();
-	unsigned int riff_chans = acm->get_channels();
-	int samplerate = acm->get_samplerate();
-	//multiply always by 2 because it is in 16 bits
-	int rawsize = cnt * 2;
-	short* memory = (short*) malloc(rawsize);
-	//multiply always with 2 because it is in 16 bits
-	unsigned int cnt1 = acm->read_samples( memory, cnt ) * 2;
-	//Sound Length in milliseconds
-	time_length = ((cnt / riff_chans) * 1000) / samplerate;
-	//it is always reading the stuff into 16 bits
-	alBufferData( Buffer, GetFormatEnum( riff_chans, 16 ), memory, cnt1, samplerate );
-	free(memory);
-
-	if (checkALError("Unable to fill buffer", ERROR)) {
-		alDeleteBuffers( 1, &Buffer );
-		checkALError("Error deleting buffer", WARNING);
 		return 0;
 	}
 
 	e = new CacheEntry;
-	e->Buffer = Buffer;
-	e->Length = time_length;
-
-	buffercache.SetAt(key, (void*)e);
-	//print("LoadSound: added %s to cache: %d. Cache size now %d", ResRef, e->Buffer, buffercache.GetCount());
-
-	if (buffercache.GetCount() > BUFFER_CACHE_SIZE) {
-		evictBuffer();
+	if (!DecodeSound(*acm, *e)) {
+		delete e;
+		return 0;
 	}
+	time_length = e->Length;
+	ALuint Buffer = e->Buffer;
+	AddToCache(key, e);
 	return Buffer;
 }
 
@@ -778,7 +933,8 @@ tick_t OpenALAudioDriver::QueueAmbient(int stream, const ResRef& sound)
 	streams[stream].ClearProcessedBuffers();
 
 	tick_t time_length;
-	ALuint Buffer = loadSound(sound, time_length);
+	// called from the AmbientMgr thread
+	ALuint Buffer = loadSound(sound, time_length, false);
 	if (0 == Buffer) {
 		return -1;
 	}
@@ -831,6 +987,7 @@ bool OpenALAudioDriver::evictBuffer()
 			// Buffer was unused. An error would have indicated
 			// the buffer was still attached to a source.
 
+			buffercacheBytes -= e->Size;
 			delete e;
 			buffercache.Remove(k);
 
@@ -854,6 +1011,7 @@ void OpenALAudioDriver::clearBufferCache(bool force)
 		CacheEntry* e = (CacheEntry*)p;
 		alDeleteBuffers(1, &e->Buffer);
 		if (force || alGetError() == AL_NO_ERROR) {
+			buffercacheBytes -= e->Size;
 			delete e;
 			buffercache.Remove(k);
 		} else
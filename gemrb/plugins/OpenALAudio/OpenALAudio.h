@@ -29,12 +29,16 @@
 
 #include "LRUCache.h"
 #include "MusicMgr.h"
+#include "Resource.h"
 #include "SoundMgr.h"
 #include "Streams/FileStream.h"
 #include "MapReverb.h"
 
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #if __APPLE__
 #include <OpenAL/OpenAL.h> // umbrella include for all the headers we want
@@ -47,7 +51,8 @@
 #endif
 
 #define RETRY 5
-#define BUFFER_CACHE_SIZE 100
+// decoded sounds are kept around up to this many bytes of PCM
+#define BUFFER_CACHE_BYTES (64 * 1024 * 1024)
 #define MAX_STREAMS 30
 #define MUSICBUFFERS 10
 #define REFERENCE_DISTANCE 50
@@ -89,8 +94,26 @@ struct AudioStream {
 };
 
 struct CacheEntry {
-	ALuint Buffer;
-	tick_t Length;
+	ALuint Buffer = 0;
+	tick_t Length = 0;
+	size_t Size = 0;
+};
+
+// 16 bit samples read from a sound, not uploaded to OpenAL yet
+struct DecodedSound {
+	std::vector<short> samples;
+	int length = 0; // as reported by the reader, for the duration
+	unsigned int channels = 1;
+	int samplerate = 0;
+};
+
+// a sound handed to the decoder thread by Prefetch
+// the thread only reads the samples, all the AL calls stay on the main thread
+struct DecodeJob {
+	std::shared_ptr<SoundMgr> reader;
+	DecodedSound sound;
+	bool started = false;
+	bool done = false;
 };
 
 class OpenALAudioDriver : public Audio {
@@ -122,6 +145,7 @@ public:
 				int channels, short* memory,
 				int size, int samplerate) override;
 	void UpdateMapAmbient(MapReverb&) override;
+	void Prefetch(const std::vector<ResRef>&) override;
 private:
 	int QueueALBuffer(ALuint source, ALuint buffer) const;
 
@@ -133,6 +157,7 @@ private:
 	ALuint MusicBuffer[MUSICBUFFERS]{};
 	std::shared_ptr<SoundMgr> MusicReader;
 	LRUCache buffercache;
+	size_t buffercacheBytes = 0;
 	AudioStream speech;
 	AudioStream streams[MAX_STREAMS];
 	int num_streams = 0;
@@ -141,13 +166,28 @@ private:
 	short* music_memory;
 	std::thread musicThread;
 
+	// prefetched sounds not in the buffercache yet, the jobs waiting for the decoder thread
+	// and their state are all guarded by decodeMutex, since loadSound also runs on the ambient thread
+	ResRefMap<std::shared_ptr<DecodeJob>> pendingDecodes;
+	std::deque<std::shared_ptr<DecodeJob>> decodeQueue;
+	std::mutex decodeMutex;
+	std::condition_variable decodeCond;
+	std::thread decodeThread;
+
 	bool hasReverbProperties = false;
 	bool hasEFX = false;
 	ALuint efxEffectSlot = 0;
 	ALuint efxEffect = 0;
 	MapReverbProperties reverbProperties;
 
-	ALuint loadSound(StringView ResRef, tick_t &time_length);
+	ALuint loadSound(StringView ResRef, tick_t &time_length, bool mainThread = true);
+	static void ReadSound(SoundMgr& reader, DecodedSound& sound);
+	bool UploadSound(const DecodedSound& sound, CacheEntry& entry) const;
+	bool DecodeSound(SoundMgr& reader, CacheEntry& entry) const;
+	void AddToCache(StringView ResRef, CacheEntry* entry);
+	bool FinishDecode(const ResRef& key, bool wait);
+	void CollectDecodes();
+	void DecoderLoop();
 	int CountAvailableSources(int limit);
 	bool evictBuffer();
 	void clearBufferCache(bool force);
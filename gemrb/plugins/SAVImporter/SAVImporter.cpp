@@ -21,9 +21,32 @@
 #include "Compressor.h"
 #include "Interface.h"
 #include "PluginMgr.h"
+#include "Streams/FileStream.h"
+#include "Streams/MemoryStream.h"
+
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 using namespace GemRB;
 
+// a member of the archive that needs to be inflated into the cache
+struct SAVMember {
+	std::string path;
+	std::unique_ptr<DataStream> data;
+	bool created = false;
+	bool ok = false;
+};
+
+static void InflateMember(const Compressor& comp, SAVMember& member)
+{
+	FileStream out;
+	member.created = out.Create(member.path.c_str());
+	if (!member.created) return;
+	member.ok = comp.Decompress(&out, member.data.get(), static_cast<unsigned int>(member.data->Size())) == GEM_OK;
+}
+
 int SAVImporter::DecompressSaveGame(DataStream *compressed, SaveGameAREExtractor& areExtractor)
 {
 	char Signature[8];
@@ -36,8 +59,18 @@ int SAVImporter::DecompressSaveGame(DataStream *compressed, SaveGameAREExtractor
 	size_t percent;
 	size_t last_percent = 20;
 	if (!All) return GEM_ERROR;
+	if (!core->IsAvailable(PLUGIN_COMPRESSION_ZLIB)) {
+		Log(ERROR, "SAVImporter", "No Compression Manager Available. Cannot Load Compressed File.");
+		return GEM_ERROR;
+	}
 
 	tick_t startTime = GetMilliseconds();
+	// first pass: index the members and slurp the compressed data
+	// the archive stream is only ever touched from this thread
+	std::vector<SAVMember> members;
+	// members that share a name would be inflated into the same file at once,
+	// so only the last one is kept, which is what ended up in the cache when going in order
+	std::unordered_map<std::string, size_t> memberIndex;
 	do {
 		ieDword fnlen, complen, declen;
 		compressed->ReadDword(fnlen);
@@ -62,16 +95,32 @@ int SAVImporter::DecompressSaveGame(DataStream *compressed, SaveGameAREExtractor
 			compressed->Seek(complen, GEM_CURRENT_POS);
 		} else {
 			Log(MESSAGE, "SAVImporter", "Decompressing {}", fname);
-			DataStream* cached = CacheCompressedStream(compressed, fname, complen, true);
-
-			if (!cached)
+			void* buffer = malloc(complen);
+			if (compressed->Read(buffer, complen) != static_cast<strret_t>(complen)) {
+				Log(ERROR, "SAVImporter", "Corrupt Save Detected");
+				free(buffer);
 				return GEM_ERROR;
-			delete cached;
+			}
+			char cacheName[_MAX_PATH];
+			char path[_MAX_PATH];
+			ExtractFileFromPath(cacheName, fname.c_str());
+			PathJoin(path, core->config.CachePath, cacheName, nullptr);
+
+			SAVMember member;
+			member.path = path;
+			member.data.reset(new MemoryStream(fname.c_str(), buffer, complen));
+			auto known = memberIndex.find(member.path);
+			if (known != memberIndex.end()) {
+				members[known->second] = std::move(member);
+			} else {
+				memberIndex.emplace(member.path, members.size());
+				members.push_back(std::move(member));
+			}
 		}
 
 		Current = compressed->Remains();
-		//starting at 20% going up to 70%
-		percent = (20 + (All - Current) * 50 / All);
+		//starting at 20% going up to 30%
+		percent = (20 + (All - Current) * 10 / All);
 		if (percent - last_percent > 5) {
 			core->LoadProgress(static_cast<int>(percent));
 			last_percent = percent;
@@ -79,6 +128,54 @@ int SAVImporter::DecompressSaveGame(DataStream *compressed, SaveGameAREExtractor
 	}
 	while(Current);
 
+	// second pass: inflate the members on all cores, each into its own cache file
+	// the calling thread helps out and is the only one reporting progress
+	size_t workerCount = std::max(1u, std::thread::hardware_concurrency());
+	workerCount = std::min(workerCount, members.size());
+	std::vector<PluginHolder<Compressor>> compressors;
+	for (size_t i = 0; i < std::max<size_t>(workerCount, 1); ++i) {
+		compressors.push_back(MakePluginHolder<Compressor>(PLUGIN_COMPRESSION_ZLIB));
+	}
+
+	std::atomic<size_t> nextMember {0};
+	std::atomic<size_t> doneMembers {0};
+	auto work = [&](const Compressor& comp, bool report) {
+		size_t idx;
+		while ((idx = nextMember++) < members.size()) {
+			InflateMember(comp, members[idx]);
+			members[idx].data.reset();
+			size_t done = ++doneMembers;
+			if (!report) continue;
+
+			//going up to 70%
+			percent = 30 + done * 40 / members.size();
+			if (percent - last_percent > 5) {
+				core->LoadProgress(static_cast<int>(percent));
+				last_percent = percent;
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t i = 1; i < workerCount; ++i) {
+		workers.emplace_back(work, std::cref(*compressors[i]), false);
+	}
+	work(*compressors[0], true);
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	for (const auto& member : members) {
+		if (!member.created) {
+			Log(ERROR, "SAVImporter", "Cannot write {}.", member.path);
+			return GEM_ERROR;
+		}
+		if (!member.ok) {
+			Log(ERROR, "SAVImporter", "Failed to decompress {}!", member.path);
+			return GEM_ERROR;
+		}
+	}
+
 	tick_t endTime = GetMilliseconds();
 	Log(WARNING, "Core", "{} ms (extracting the SAV)", endTime - startTime);
 	return GEM_OK;
@@ -98,7 +195,7 @@ int SAVImporter::CreateArchive(DataStream *compressed)
 	return GEM_OK;
 }
 
-int SAVImporter::AddToSaveGame(DataStream *str, DataStream *uncompressed)
+int SAVImporter::AddToSaveGame(DataStream *str, DataStream *uncompressed, int level)
 {
 	size_t fnlen = strlen(uncompressed->filename)+1;
 	strpos_t declen = uncompressed->Size();
@@ -112,7 +209,7 @@ int SAVImporter::AddToSaveGame(DataStream *str, DataStream *uncompressed)
 	str->WriteDword(complen);
 
 	PluginHolder<Compressor> comp = MakePluginHolder<Compressor>(PLUGIN_COMPRESSION_ZLIB);
-	comp->Compress( str, uncompressed );
+	comp->Compress(str, uncompressed, level);
 
 	//writing compressed length (calculated)
 	strpos_t Pos2 = str->GetPos();
@@ -73,6 +73,8 @@ SDL20VideoDriver::~SDL20VideoDriver() noexcept
 	// we cant rely on the base destructor here
 	scratchBuffer = nullptr;
 	DestroyBuffers();
+	batch = nullptr;
+	atlas = nullptr;
 
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
@@ -149,6 +151,15 @@ int SDL20VideoDriver::CreateSDLDisplay(const char* title)
 		return GEM_ERROR;
 	}
 
+#if SDL_RENDER_BATCH_SUPPORTED && !USE_OPENGL_BACKEND
+	// the GL backend needs to set shader uniforms for every blit, so it can't batch them
+	// the software renderer rasterizes geometry with texel drift, so it's left to SDL_RenderCopyEx too
+	if (sdl2_runtime_version >= SDL_VERSIONNUM(2, 0, 18) && !(info.flags & SDL_RENDERER_SOFTWARE)) {
+		batch = GemRB::make_unique<SDLRenderBatch>(renderer, frameStats);
+		atlas = GemRB::make_unique<SDLTextureAtlas>(renderer);
+	}
+#endif
+
 #if USE_OPENGL_BACKEND
 	// glGetString can return null, fmt doesn't support const unsigned char* and std::string can handle neither
 	std::string tmp[4] = { "/" };
@@ -214,17 +225,21 @@ VideoBuffer* SDL20VideoDriver::NewVideoBuffer(const Region& r, BufferFormat fmt)
 		Log(ERROR, "SDL 2", "{}", SDL_GetError());
 		return nullptr;
 	}
-	return new SDLTextureVideoBuffer(r.origin, tex, fmt, renderer);
+	return new SDLTextureVideoBuffer(r.origin, tex, fmt, renderer, batch.get());
 }
 
 void SDL20VideoDriver::SwapBuffers(VideoBuffers& buffers)
 {
+	FlushBatch();
+
 #if USE_OPENGL_BACKEND
 	// we have coopted SDLs shader, so we need to reset uniforms to values appropriate for the render targets
 	blitRGBAShader->SetUniformValue("u_greyMode", 1, 0);
 	blitRGBAShader->SetUniformValue("u_stencil", 1, 0);
 	blitRGBAShader->SetUniformValue("u_dither", 1, 0);
 	blitRGBAShader->SetUniformValue("u_rgba", 1, 1);
+	// and the next blit has to set them all again
+	blitShaderState = BlitShaderState();
 #endif
 	
 	SDL_SetRenderTarget(renderer, NULL);
@@ -263,24 +278,35 @@ int SDL20VideoDriver::UpdateRenderTarget(const Color* color, BlitFlags flags)
 	// TODO: add support for BlitFlags::HALFTRANS, BlitFlags::COLOR_MOD, and others (no use for them ATM)
 
 	SDL_Texture* target = CurrentRenderBuffer();
-
 	assert(target);
+
+	// Some SDL backends complain on having a clip rect of the entire renderer size
+	// I'm not sure if it is an SDL bug; possibly its just 0 based so it is out of bounds?
+	const SDL_Rect* clip = nullptr;
+	if (screenClip.size != screenSize) {
+		clip = reinterpret_cast<const SDL_Rect*>(&screenClip);
+	}
+
+	if (batch) {
+		if (color) {
+			// primitives are never batched
+			batch->Flush();
+		} else {
+			batch->SetTarget(target, clip);
+		}
+	}
+
 	int ret = SDL_SetRenderTarget(renderer, target);
 	if (ret != 0) {
 		Log(ERROR, "SDLVideo", "{}", SDL_GetError());
 		return ret;
 	}
 
-	if (screenClip.size == screenSize)
-	{
-		// Some SDL backends complain on having a clip rect of the entire renderer size
-		// I'm not sure if it is an SDL bug; possibly its just 0 based so it is out of bounds?
-		SDL_RenderSetClipRect(renderer, NULL);
-	} else {
-		SDL_RenderSetClipRect(renderer, reinterpret_cast<SDL_Rect*>(&screenClip));
-	}
+	SDL_RenderSetClipRect(renderer, clip);
 
 	if (color) {
+		// counting every primitive as one call, even though a filled polygon is made of many lines
+		++frameStats.drawCalls;
 		if (flags & BlitFlags::BLENDED) {
 			SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
 		} else if (flags & BlitFlags::MULTIPLY) {
@@ -295,6 +321,43 @@ int SDL20VideoDriver::UpdateRenderTarget(const Color* color, BlitFlags flags)
 	return 0;
 }
 
+static SDL_Color ModulationForFlags(BlitFlags flags, const SDL_Color* tint)
+{
+	SDL_Color mod = { 0xff, 0xff, 0xff, SDL_ALPHA_OPAQUE };
+	if (flags & BlitFlags::ALPHA_MOD) {
+		mod.a = tint->a;
+	}
+
+	if (flags & BlitFlags::HALFTRANS) {
+		mod.a /= 2;
+	}
+
+	if (flags & BlitFlags::COLOR_MOD) {
+		mod.r = tint->r;
+		mod.g = tint->g;
+		mod.b = tint->b;
+	}
+	return mod;
+}
+
+static SDL_BlendMode BlendModeForFlags(BlitFlags flags)
+{
+	if (flags & BlitFlags::ADD) {
+		return SDL_BLENDMODE_ADD;
+	} else if (flags & BlitFlags::MULTIPLY) {
+		return SDL_BLENDMODE_MOD;
+	} else if (flags & (BlitFlags::BLENDED | BlitFlags::HALFTRANS)) {
+		return SDL_BLENDMODE_BLEND;
+	}
+	return SDL_BLENDMODE_NONE;
+}
+
+static SDL_RendererFlip FlipForFlags(BlitFlags flags)
+{
+	SDL_RendererFlip flipflags = (flags & BlitFlags::MIRRORY) ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE;
+	return static_cast<SDL_RendererFlip>(flipflags | ((flags & BlitFlags::MIRRORX) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE));
+}
+
 void SDL20VideoDriver::BlitSpriteNativeClipped(const SDLTextureSprite2D* spr, const Region& src, const Region& dst, BlitFlags flags, const SDL_Color* tint)
 {
 	BlitFlags version = BlitFlags::NONE;
@@ -310,8 +373,30 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(const SDLTextureSprite2D* spr, co
 		flags &= ~spr->RenderWithFlags(version);
 	}
 
-	SDL_Texture* tex = spr->GetTexture(renderer);
-	BlitSpriteNativeClipped(tex, src, dst, flags, tint);
+	if (atlas && spr->IsTextureStale()) {
+		// pending draws of the old pixels must not pick up the new ones
+		FlushBatch();
+	}
+
+	SDL_Point origin;
+	SDL_Texture* tex = spr->GetTexture(renderer, atlas.get(), &origin);
+	// SDL would clip to the texture, which is now possibly shared with other sprites
+	Region srgn = src.Intersect(Region(Point(), spr->Frame.size));
+	if (srgn.size.IsInvalid()) {
+		return;
+	}
+	srgn.x += origin.x;
+	srgn.y += origin.y;
+
+	if (batch && spr->IsInAtlas() && !(flags & BLIT_STENCIL_MASK)) {
+		UpdateRenderTarget();
+		SDL_Rect srect = RectFromRegion(srgn);
+		SDL_Rect drect = RectFromRegion(dst);
+		batch->Add(tex, srect, drect, ModulationForFlags(flags, tint), BlendModeForFlags(flags), FlipForFlags(flags));
+		return;
+	}
+
+	BlitSpriteNativeClipped(tex, srgn, dst, flags, tint);
 }
 
 void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Region& srgn, const Region& drgn, BlitFlags flags, const SDL_Color* tint)
@@ -321,6 +406,7 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 	
 	int ret = 0;
 	if (flags&BLIT_STENCIL_MASK) {
+		FlushBatch();
 		// 1. clear scratchpad segment
 		// 2. blend stencil segment to scratchpad
 		// 3. blend texture to scratchpad
@@ -342,6 +428,7 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 		stencilRect.x -= stencilBuffer->Origin().x;
 		stencilRect.y -= stencilBuffer->Origin().y;
 		SDL_RenderCopy(renderer, stencilTex, &stencilRect, &drect);
+		frameStats.drawCalls += 2; // the clear and the stencil
 #endif
 
 		if (flags & (BlitFlags::ALPHA_MOD | BlitFlags::HALFTRANS)) {
@@ -358,6 +445,7 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 		SDL_SetRenderTarget(renderer, CurrentRenderBuffer());
 		SDL_SetTextureBlendMode(ScratchBuffer(), SDL_BLENDMODE_BLEND);
 		ret = SDL_RenderCopy(renderer, ScratchBuffer(), &drect, &drect);
+		++frameStats.drawCalls;
 	} else {
 		UpdateRenderTarget();
 		ret = RenderCopyShaded(texSprite, &srect, &drect, flags, tint);
@@ -379,46 +467,64 @@ void SDL20VideoDriver::BlitVideoBuffer(const VideoBufferPtr& buf, const Point& p
 	BlitSpriteNativeClipped(tex, srect, drect, flags, reinterpret_cast<const SDL_Color*>(&tint));
 }
 
+void SDL20VideoDriver::FlushBatch()
+{
+	if (batch) {
+		batch->Flush();
+	}
+	if (atlas) {
+		// nothing pending can refer to released cells anymore
+		atlas->Recycle();
+	}
+}
+
 int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* srcrect,
 									   const SDL_Rect* dstrect, BlitFlags flags, const SDL_Color* tint)
 {
-#if USE_OPENGL_BACKEND
-#if SDL_VERSION_ATLEAST(2, 0, 10)
-	SDL_RenderFlush(renderer);
-#endif
+	FlushBatch();
 
+#if USE_OPENGL_BACKEND
 	uint32_t format = 0;
 	SDL_QueryTexture(texture, &format, nullptr, nullptr, nullptr);
-	blitRGBAShader->Use();
-	
-	blitRGBAShader->SetUniformValue("s_sprite", 1, 0);
-	blitRGBAShader->SetUniformValue("s_stencil", 1, 1);
-	
-	bool isRGBA = SDL_ISPIXELFORMAT_ALPHA(format);
-	blitRGBAShader->SetUniformValue("u_rgba", 1, isRGBA ? 1 : 0);
 
-	GLint greyMode = 0;
+	BlitShaderState state;
+	state.rgba = SDL_ISPIXELFORMAT_ALPHA(format) ? 1 : 0;
+
+	state.greyMode = 0;
 	if (flags & BlitFlags::GREY) {
-		greyMode = 1;
+		state.greyMode = 1;
 	} else if (flags & BlitFlags::SEPIA) {
-		greyMode = 2;
+		state.greyMode = 2;
 	}
 
-	blitRGBAShader->SetUniformValue("u_greyMode", 1, greyMode);
-
-	GLint channel = 3;
+	state.channel = 3;
 	if (flags & BlitFlags::STENCIL_RED) {
-		channel = 0;
+		state.channel = 0;
 	} else if (flags & BlitFlags::STENCIL_GREEN) {
-		channel = 1;
+		state.channel = 1;
 	} else if (flags & BlitFlags::STENCIL_BLUE) {
-		channel = 2;
+		state.channel = 2;
 	}
 
-	blitRGBAShader->SetUniformValue("u_channel", 1, channel);
-
 	bool doStencil = flags & BLIT_STENCIL_MASK;
-	blitRGBAShader->SetUniformValue("u_stencil", 1, doStencil ? 1 : 0);
+	state.stencil = doStencil ? 1 : 0;
+
+	// the uniforms apply to everything SDL has queued, so we must flush before changing them
+	// consecutive blits with the same settings can stay in the SDL batch though
+	if (doStencil || !(state == blitShaderState)) {
+#if SDL_VERSION_ATLEAST(2, 0, 10)
+		SDL_RenderFlush(renderer);
+#endif
+		blitRGBAShader->Use();
+
+		blitRGBAShader->SetUniformValue("s_sprite", 1, 0);
+		blitRGBAShader->SetUniformValue("s_stencil", 1, 1);
+		blitRGBAShader->SetUniformValue("u_rgba", 1, state.rgba);
+		blitRGBAShader->SetUniformValue("u_greyMode", 1, state.greyMode);
+		blitRGBAShader->SetUniformValue("u_channel", 1, state.channel);
+		blitRGBAShader->SetUniformValue("u_stencil", 1, state.stencil);
+		blitShaderState = state;
+	}
 
 	if (doStencil) {
 		assert(stencilBuffer && dstrect);
@@ -477,37 +583,13 @@ int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* src
 	}
 #endif
 	
-	Uint8 alpha = SDL_ALPHA_OPAQUE;
-	if (flags & BlitFlags::ALPHA_MOD) {
-		alpha = tint->a;
-	}
-	
-	if (flags & BlitFlags::HALFTRANS) {
-		alpha /= 2;
-	}
-	
-	SDL_SetTextureAlphaMod(texture, alpha);
-
-	if (flags & BlitFlags::COLOR_MOD) {
-		SDL_SetTextureColorMod(texture, tint->r, tint->g, tint->b);
-	} else {
-		SDL_SetTextureColorMod(texture, 0xff, 0xff, 0xff);
-	}
-	
-	if (flags & BlitFlags::ADD) {
-		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_ADD);
-	} else if (flags & BlitFlags::MULTIPLY) {
-		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_MOD);
-	} else if (flags & (BlitFlags::BLENDED | BlitFlags::HALFTRANS)) {
-		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-	} else {
-		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
-	}
-
-	SDL_RendererFlip flipflags = (flags & BlitFlags::MIRRORY) ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE;
-	flipflags = static_cast<SDL_RendererFlip>(flipflags | ((flags & BlitFlags::MIRRORX) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE));
+	SDL_Color mod = ModulationForFlags(flags, tint);
+	SDL_SetTextureAlphaMod(texture, mod.a);
+	SDL_SetTextureColorMod(texture, mod.r, mod.g, mod.b);
+	SDL_SetTextureBlendMode(texture, BlendModeForFlags(flags));
 
-	return SDL_RenderCopyEx(renderer, texture, srcrect, dstrect, 0.0, nullptr, flipflags);
+	++frameStats.drawCalls;
+	return SDL_RenderCopyEx(renderer, texture, srcrect, dstrect, 0.0, nullptr, FlipForFlags(flags));
 }
 
 void SDL20VideoDriver::DrawPointsImp(const std::vector<Point>& points, const Color& color, BlitFlags flags)
@@ -599,6 +681,7 @@ Holder<Sprite2D> SDL20VideoDriver::GetScreenshot(Region r, const VideoBufferPtr&
 	static const PixelFormat fmt(3, 0x00ff0000, 0x0000ff00, 0x000000ff, 0);
 	SDLTextureSprite2D* screenshot = new SDLTextureSprite2D(Region(0,0, Width, Height), fmt);
 
+	FlushBatch();
 	SDL_Texture* target = SDL_GetRenderTarget(renderer);
 	if (buf) {
 		auto texture = static_cast<SDLTextureVideoBuffer*>(buf.get())->GetTexture();
@@ -22,7 +22,9 @@
 #define SDL20VideoDRIVER_H
 
 #include "SDLVideo.h"
+#include "SDLRenderBatch.h"
 #include "SDLSurfaceSprite2D.h"
+#include "SDLTextureAtlas.h"
 
 #if USE_OPENGL_BACKEND
 #include "GLSLProgram.h"
@@ -76,6 +78,9 @@ class SDLTextureVideoBuffer : public VideoBuffer {
 	// this is also used for rendering stencils
 	SDL_Surface* conversionBuffer = nullptr;
 
+	// pending batched draws have to happen before anything we do with the texture
+	SDLRenderBatch* batch;
+
 private:
 	static Region TextureRegion(SDL_Texture* tex, const Point& p) {
 		int w, h;
@@ -84,8 +89,8 @@ private:
 	}
 
 public:
-	SDLTextureVideoBuffer(const Point& p, SDL_Texture* texture, Video::BufferFormat fmt, SDL_Renderer* renderer)
-	: VideoBuffer(TextureRegion(texture, p)), texture(texture), renderer(renderer), inputFormat(SDLPixelFormatFromBufferFormat(fmt, NULL))
+	SDLTextureVideoBuffer(const Point& p, SDL_Texture* texture, Video::BufferFormat fmt, SDL_Renderer* renderer, SDLRenderBatch* batch = nullptr)
+	: VideoBuffer(TextureRegion(texture, p)), texture(texture), renderer(renderer), inputFormat(SDLPixelFormatFromBufferFormat(fmt, NULL)), batch(batch)
 	{
 		assert(texture);
 		assert(renderer);
@@ -105,7 +110,14 @@ public:
 		SDL_FreeSurface(conversionBuffer);
 	}
 
+	void FlushBatch() const {
+		if (batch) {
+			batch->Flush();
+		}
+	}
+
 	void Clear() override {
+		FlushBatch();
 		SDL_SetRenderTarget(renderer, texture);
 		SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
 #if SDL_COMPILEDVERSION == SDL_VERSIONNUM(2, 0, 10)
@@ -120,6 +132,7 @@ public:
 	}
 	
 	void Clear(const SDL_Rect& rgn) {
+		FlushBatch();
 		SDL_SetRenderTarget(renderer, texture);
 		SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
 		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
@@ -131,6 +144,7 @@ public:
 	}
 
 	bool RenderOnDisplay(void* display) const override {
+		FlushBatch();
 		SDL_Renderer* targetRenderer = static_cast<SDL_Renderer*>(display);
 		SDL_Rect dst = RectFromRegion(rect);
 		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
@@ -142,6 +156,7 @@ public:
 	}
 
 	void CopyPixels(const Region& bufDest, const void* pixelBuf, const int* pitch = NULL, ...) override {
+		FlushBatch();
 		int sdlpitch = bufDest.w * SDL_BYTESPERPIXEL(nativeFormat);
 		SDL_Rect dest = RectFromRegion(bufDest);
 
@@ -219,6 +234,23 @@ private:
 	SDL_GameController* gameController = nullptr;
 
 	GLSLProgram* blitRGBAShader = nullptr;
+#if USE_OPENGL_BACKEND
+	// the uniforms last set on blitRGBAShader, so we only flush SDL when they change
+	struct BlitShaderState {
+		GLint rgba = -1;
+		GLint greyMode = -1;
+		GLint channel = -1;
+		GLint stencil = -1;
+
+		bool operator==(const BlitShaderState& rhs) const {
+			return rgba == rhs.rgba && greyMode == rhs.greyMode && channel == rhs.channel && stencil == rhs.stencil;
+		}
+	} blitShaderState;
+#endif
+
+	// only available for the plain SDL renderers with SDL_RenderGeometry
+	std::unique_ptr<SDLTextureAtlas> atlas;
+	std::unique_ptr<SDLRenderBatch> batch;
 public:
 	SDL20VideoDriver() noexcept;
 	~SDL20VideoDriver() noexcept override;
@@ -276,6 +308,7 @@ private:
 	void BlitSpriteNativeClipped(SDL_Texture* spr, const Region& src, const Region& dst, BlitFlags flags = BlitFlags::NONE, const SDL_Color* tint = NULL);
 
 	int RenderCopyShaded(SDL_Texture*, const SDL_Rect* srcrect, const SDL_Rect* dstrect, BlitFlags flags, const SDL_Color* = nullptr);
+	void FlushBatch();
 
 	int GetTouchFingers(TouchEvent::Finger(&fingers)[FINGER_MAX], SDL_TouchID device) const;
 };
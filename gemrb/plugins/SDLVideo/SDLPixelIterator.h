@@ -23,6 +23,8 @@
 
 #include "Video/Pixels.h"
 
+#include <vector>
+
 namespace GemRB {
 
 using SDLPixelIterator = PixelFormatIterator;
@@ -119,10 +121,49 @@ static void Blit(SDLPixelIterator src,
 	}
 }
 
+// fast path for 32bpp surfaces, blending whole rows at a time
+template <typename BLENDER>
+static bool BlitBlendedSpans(const SDLPixelIterator& src, const SDLPixelIterator& dst,
+							 const BLENDER& blender, IAlphaIterator* maskIt)
+{
+	if (!src.format.IsRGBA32() || !dst.format.IsRGBA32()) return false;
+	if (src.clip.w != dst.clip.w || src.clip.h != dst.clip.h) return false;
+
+	const int w = dst.clip.w;
+	std::vector<Color> srcRow(w);
+	std::vector<Color> dstRow(w);
+	std::vector<uint8_t> maskRow(w, 0);
+	// the iterators start at the first pixel to visit, also for mirrored blits
+	const uint8_t* srcStart = &*src;
+	uint8_t* dstStart = &*dst;
+
+	for (int y = 0; y < dst.clip.h; ++y) {
+		const uint32_t* srcPx = reinterpret_cast<const uint32_t*>(srcStart + y * src.ydir * src.pitch);
+		uint32_t* dstPx = reinterpret_cast<uint32_t*>(dstStart + y * dst.ydir * dst.pitch);
+
+		ReadRGBASpan(src.format, srcPx, src.xdir, srcRow.data(), w);
+		ReadRGBASpan(dst.format, dstPx, dst.xdir, dstRow.data(), w);
+		if (maskIt) {
+			for (uint8_t& mask : maskRow) {
+				mask = **maskIt;
+				++*maskIt;
+			}
+		}
+
+		blender(srcRow.data(), dstRow.data(), maskRow.data(), w);
+		WriteRGBASpan(dst.format, dstRow.data(), dstPx, dst.xdir, w);
+	}
+	return true;
+}
+
 template <typename BLENDER>
 static void BlitBlendedRect(SDLPixelIterator& src, SDLPixelIterator& dst,
 							BLENDER blender, IAlphaIterator* maskIt)
 {
+	if (BlitBlendedSpans(src, dst, blender, maskIt)) {
+		return;
+	}
+
 	SDLPixelIterator dstend = SDLPixelIterator::end(dst);
 
 	if (maskIt) {
@@ -0,0 +1,121 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "SDLRenderBatch.h"
+
+#include "Logging/Logging.h"
+
+#include <cassert>
+#include <initializer_list>
+#include <utility>
+
+namespace GemRB {
+
+SDLRenderBatch::SDLRenderBatch(SDL_Renderer* renderer, Video::RenderStats& stats)
+: renderer(renderer), stats(stats)
+{}
+
+void SDLRenderBatch::SetTarget(SDL_Texture* tex, const SDL_Rect* rect)
+{
+	bool same = tex == target && (rect != nullptr) == clipped;
+	if (same && rect) {
+		same = rect->x == clip.x && rect->y == clip.y && rect->w == clip.w && rect->h == clip.h;
+	}
+	if (same) return;
+
+	Flush();
+	target = tex;
+	clipped = rect != nullptr;
+	if (rect) {
+		clip = *rect;
+	}
+}
+
+void SDLRenderBatch::Add(SDL_Texture* tex, const SDL_Rect& src, const SDL_Rect& dst,
+						 const SDL_Color& mod, SDL_BlendMode mode, SDL_RendererFlip flip)
+{
+#if SDL_RENDER_BATCH_SUPPORTED
+	if (tex != texture || mode != blendMode) {
+		Flush();
+		texture = tex;
+		blendMode = mode;
+		int w = 1, h = 1;
+		SDL_QueryTexture(tex, nullptr, nullptr, &w, &h);
+		texW = float(w);
+		texH = float(h);
+	}
+
+	float u1 = src.x / texW;
+	float v1 = src.y / texH;
+	float u2 = (src.x + src.w) / texW;
+	float v2 = (src.y + src.h) / texH;
+	if (flip & SDL_FLIP_HORIZONTAL) {
+		std::swap(u1, u2);
+	}
+	if (flip & SDL_FLIP_VERTICAL) {
+		std::swap(v1, v2);
+	}
+
+	float x1 = float(dst.x);
+	float y1 = float(dst.y);
+	float x2 = float(dst.x + dst.w);
+	float y2 = float(dst.y + dst.h);
+
+	int first = int(vertices.size());
+	vertices.push_back({ { x1, y1 }, mod, { u1, v1 } });
+	vertices.push_back({ { x2, y1 }, mod, { u2, v1 } });
+	vertices.push_back({ { x1, y2 }, mod, { u1, v2 } });
+	vertices.push_back({ { x2, y2 }, mod, { u2, v2 } });
+
+	for (int idx : { 0, 1, 2, 2, 1, 3 }) {
+		indices.push_back(first + idx);
+	}
+#else
+	(void) tex; (void) src; (void) dst; (void) mod; (void) mode; (void) flip;
+	assert(false);
+#endif
+}
+
+void SDLRenderBatch::Flush()
+{
+	if (Empty()) return;
+
+#if SDL_RENDER_BATCH_SUPPORTED
+	// the modulation is in the vertices, the texture ones would be applied on top
+	SDL_SetTextureColorMod(texture, 0xff, 0xff, 0xff);
+	SDL_SetTextureAlphaMod(texture, SDL_ALPHA_OPAQUE);
+	SDL_SetTextureBlendMode(texture, blendMode);
+
+	int ret = SDL_RenderGeometry(renderer, texture, vertices.data(), int(vertices.size()),
+								 indices.data(), int(indices.size()));
+	if (ret != 0) {
+		Log(ERROR, "SDLRenderBatch", "{}", SDL_GetError());
+	}
+
+	++stats.drawCalls;
+	++stats.batches;
+	stats.batchedSprites += vertices.size() / 4;
+	vertices.clear();
+#endif
+	indices.clear();
+	texture = nullptr;
+}
+
+}
@@ -0,0 +1,74 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef SDLRENDERBATCH_H
+#define SDLRENDERBATCH_H
+
+#include "Video/Video.h"
+
+#include <SDL.h>
+
+#include <vector>
+
+// SDL_RenderGeometry is what makes batching possible
+#define SDL_RENDER_BATCH_SUPPORTED SDL_VERSION_ATLEAST(2, 0, 18)
+
+namespace GemRB {
+
+/**
+ * @class SDLRenderBatch
+ * Collects consecutive sprite blits sharing texture, blend mode, render target
+ * and clip, and submits them as a single SDL_RenderGeometry call.
+ * The color and alpha modulation go into the vertices, so tints don't split batches.
+ * Anything else drawing with the renderer has to call Flush() first to keep the order.
+ */
+class SDLRenderBatch {
+	SDL_Renderer* renderer;
+	Video::RenderStats& stats;
+
+	SDL_Texture* target = nullptr;
+	SDL_Rect clip {};
+	bool clipped = false;
+
+	SDL_Texture* texture = nullptr;
+	SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+	float texW = 1.0f;
+	float texH = 1.0f;
+
+#if SDL_RENDER_BATCH_SUPPORTED
+	std::vector<SDL_Vertex> vertices;
+#endif
+	std::vector<int> indices;
+
+public:
+	SDLRenderBatch(SDL_Renderer*, Video::RenderStats&);
+
+	bool Empty() const noexcept { return indices.empty(); }
+
+	// to be called before changing the render target or clip, flushes if they differ from the pending ones
+	void SetTarget(SDL_Texture* target, const SDL_Rect* clip);
+	void Add(SDL_Texture*, const SDL_Rect& src, const SDL_Rect& dst,
+			 const SDL_Color& mod, SDL_BlendMode, SDL_RendererFlip);
+	void Flush();
+};
+
+}
+
+#endif
@@ -302,8 +302,31 @@ Holder<Sprite2D> SDLTextureSprite2D::copy() const
 	return Holder<Sprite2D>(new SDLTextureSprite2D(*this));
 }
 
-SDL_Texture* SDLTextureSprite2D::GetTexture(SDL_Renderer* renderer) const
+SDL_Texture* SDLTextureSprite2D::GetTexture(SDL_Renderer* renderer, SDLTextureAtlas* atlas, SDL_Point* origin) const
 {
+	if (atlas && texture == nullptr && !atlasSlot) {
+		const SDL_Surface* surface = GetSurface();
+		atlasSlot = atlas->Allocate(surface->w, surface->h);
+		staleTexture = bool(atlasSlot);
+	}
+
+	if (atlasSlot) {
+		if (staleTexture) {
+			if (atlasSlot.Upload(GetSurface()) != 0) {
+				Log(ERROR, "SDLTextureSprite2D", "Unable to upload to the atlas: {}", SDL_GetError());
+			}
+			staleTexture = false;
+		}
+		if (origin) {
+			*origin = atlasSlot.Origin();
+		}
+		return atlasSlot.Texture();
+	}
+
+	if (origin) {
+		*origin = SDL_Point { 0, 0 };
+	}
+
 	if (texture == nullptr) {
 		texture = SDL_CreateTextureFromSurface(renderer, GetSurface());
 		SDL_QueryTexture(texture, &texFormat, nullptr, nullptr, nullptr);
@@ -26,6 +26,10 @@
 
 #include <SDL.h>
 
+#if SDL_VERSION_ATLEAST(1,3,0)
+#include "SDLTextureAtlas.h"
+#endif
+
 namespace GemRB {
 
 class SDLSurfaceSprite2D : public Sprite2D {
@@ -81,6 +85,7 @@ class SDLTextureSprite2D : public SDLSurfaceSprite2D {
 	mutable Uint32 texFormat = SDL_PIXELFORMAT_UNKNOWN;
 	mutable SDL_Texture* texture = nullptr;
 	mutable bool staleTexture = false;
+	mutable SDLTextureAtlas::Slot atlasSlot; // used instead of 'texture' for small sprites
 	
 	void Invalidate() const noexcept override;
 public:
@@ -91,7 +96,11 @@ public:
 	
 	Holder<Sprite2D> copy() const override;
 	
-	SDL_Texture* GetTexture(SDL_Renderer* renderer) const;
+	// the texture may be an atlas page shared with other sprites, 'origin' is where the sprite starts in it
+	SDL_Texture* GetTexture(SDL_Renderer* renderer, SDLTextureAtlas* atlas = nullptr, SDL_Point* origin = nullptr) const;
+	bool IsInAtlas() const noexcept { return bool(atlasSlot); }
+	// the next GetTexture() is going to upload the pixels again
+	bool IsTextureStale() const noexcept { return staleTexture; }
 };
 #endif
 
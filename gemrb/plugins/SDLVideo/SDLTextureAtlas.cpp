@@ -0,0 +1,179 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "SDLTextureAtlas.h"
+
+#include "Logging/Logging.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace GemRB {
+
+SDLTextureAtlas::Page::~Page()
+{
+	SDL_DestroyTexture(texture);
+}
+
+SDLTextureAtlas::Slot::Slot(std::shared_ptr<Page> page, int cell) noexcept
+: page(std::move(page)), cell(cell)
+{}
+
+SDLTextureAtlas::Slot::Slot(Slot&& other) noexcept
+: page(std::move(other.page)), cell(other.cell)
+{
+	other.cell = -1;
+}
+
+SDLTextureAtlas::Slot::~Slot() noexcept
+{
+	Release();
+}
+
+SDLTextureAtlas::Slot& SDLTextureAtlas::Slot::operator=(Slot&& other) noexcept
+{
+	if (&other != this) {
+		Release();
+		page = std::move(other.page);
+		cell = other.cell;
+		other.cell = -1;
+	}
+	return *this;
+}
+
+void SDLTextureAtlas::Slot::Release() noexcept
+{
+	if (page) {
+		page->retiredCells.push_back(cell);
+		page = nullptr;
+		cell = -1;
+	}
+}
+
+SDL_Texture* SDLTextureAtlas::Slot::Texture() const noexcept
+{
+	return page ? page->texture : nullptr;
+}
+
+SDL_Point SDLTextureAtlas::Slot::Origin() const noexcept
+{
+	assert(page);
+	return SDL_Point { (cell % page->cellsPerRow) * CellSize, (cell / page->cellsPerRow) * CellSize };
+}
+
+int SDLTextureAtlas::Slot::Upload(SDL_Surface* surface) const
+{
+	assert(page && surface);
+	assert(Fits(surface->w, surface->h));
+
+	SDL_Point origin = Origin();
+	SDL_Rect dst { origin.x, origin.y, surface->w, surface->h };
+
+	if (surface->format->format == TextureFormat) {
+		return SDL_UpdateTexture(page->texture, &dst, surface->pixels, surface->pitch);
+	}
+
+	// this also turns the color key into alpha, like SDL_CreateTextureFromSurface does
+	SDL_Surface* temp = SDL_ConvertSurfaceFormat(surface, TextureFormat, 0);
+	if (temp == nullptr) {
+		return -1;
+	}
+	int ret = SDL_UpdateTexture(page->texture, &dst, temp->pixels, temp->pitch);
+	SDL_FreeSurface(temp);
+	return ret;
+}
+
+SDLTextureAtlas::SDLTextureAtlas(SDL_Renderer* renderer, int pageSize)
+: renderer(renderer), pageSize(pageSize)
+{
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(renderer, &info) == 0) {
+		// 0 means there is no limit
+		if (info.max_texture_width) {
+			this->pageSize = std::min(this->pageSize, info.max_texture_width);
+		}
+		if (info.max_texture_height) {
+			this->pageSize = std::min(this->pageSize, info.max_texture_height);
+		}
+	}
+	this->pageSize -= this->pageSize % CellSize;
+	assert(this->pageSize >= CellSize);
+}
+
+SDLTextureAtlas::Slot SDLTextureAtlas::Allocate(int w, int h)
+{
+	if (!Fits(w, h)) return Slot();
+
+	for (const auto& page : pages) {
+		if (!page->freeCells.empty()) {
+			int cell = page->freeCells.back();
+			page->freeCells.pop_back();
+			return Slot(page, cell);
+		}
+	}
+
+	SDL_Texture* texture = SDL_CreateTexture(renderer, TextureFormat, SDL_TEXTUREACCESS_STATIC, pageSize, pageSize);
+	if (texture == nullptr) {
+		Log(ERROR, "SDLTextureAtlas", "Unable to create a page: {}", SDL_GetError());
+		return Slot();
+	}
+#if SDL_VERSION_ATLEAST(2, 0, 12)
+	// neighbouring cells must never bleed into each other
+	SDL_SetTextureScaleMode(texture, SDL_ScaleModeNearest);
+#endif
+
+	auto page = std::make_shared<Page>();
+	page->texture = texture;
+	page->cellsPerRow = pageSize / CellSize;
+	int cells = page->cellsPerRow * page->cellsPerRow;
+	page->freeCells.reserve(cells);
+	// hand out the cells from the top left
+	for (int cell = cells - 1; cell > 0; --cell) {
+		page->freeCells.push_back(cell);
+	}
+	pages.push_back(page);
+	Log(DEBUG, "SDLTextureAtlas", "Created page {} ({}x{})", pages.size(), pageSize, pageSize);
+
+	return Slot(std::move(page), 0);
+}
+
+void SDLTextureAtlas::Recycle() noexcept
+{
+	bool keptEmpty = false;
+	for (auto it = pages.begin(); it != pages.end();) {
+		Page& page = **it;
+		page.freeCells.insert(page.freeCells.end(), page.retiredCells.begin(), page.retiredCells.end());
+		page.retiredCells.clear();
+
+		// nothing uses the page anymore, eg. after changing areas
+		// one empty page is kept, so that a sprite churning alone doesn't keep recreating it
+		if (page.freeCells.size() == size_t(page.cellsPerRow * page.cellsPerRow)) {
+			if (keptEmpty) {
+				it = pages.erase(it);
+				Log(DEBUG, "SDLTextureAtlas", "Released a page, {} left", pages.size());
+				continue;
+			}
+			keptEmpty = true;
+		}
+		++it;
+	}
+}
+
+}
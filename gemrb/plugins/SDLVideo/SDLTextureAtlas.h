@@ -0,0 +1,96 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef SDLTEXTUREATLAS_H
+#define SDLTEXTUREATLAS_H
+
+#include <SDL.h>
+
+#include <memory>
+#include <vector>
+
+namespace GemRB {
+
+/**
+ * @class SDLTextureAtlas
+ * Packs small sprites (TIS tiles, most BAM frames) into shared textures,
+ * so that consecutive blits end up using the same texture and can be batched.
+ * Every sprite gets a cell of CellSize x CellSize, which keeps allocation trivial
+ * and matches the tiles exactly. Cells are taken from the oldest pages first,
+ * so the newer ones drain and get freed once their sprites are gone.
+ */
+class SDLTextureAtlas {
+	struct Page {
+		SDL_Texture* texture = nullptr;
+		int cellsPerRow = 0;
+		std::vector<int> freeCells;
+		// released cells wait here until pending draws using them have been submitted
+		std::vector<int> retiredCells;
+
+		~Page();
+	};
+
+public:
+	static const int CellSize = 64;
+	static const Uint32 TextureFormat = SDL_PIXELFORMAT_ARGB8888;
+
+	class Slot {
+		std::shared_ptr<Page> page;
+		int cell = -1;
+
+		friend class SDLTextureAtlas;
+		Slot(std::shared_ptr<Page> page, int cell) noexcept;
+	public:
+		Slot() noexcept = default;
+		Slot(const Slot&) = delete;
+		Slot(Slot&&) noexcept;
+		~Slot() noexcept;
+
+		Slot& operator=(const Slot&) = delete;
+		Slot& operator=(Slot&&) noexcept;
+
+		explicit operator bool() const noexcept { return page != nullptr; }
+
+		SDL_Texture* Texture() const noexcept;
+		// position of the cell in the texture
+		SDL_Point Origin() const noexcept;
+		// copies the surface into the cell, converting it as necessary
+		int Upload(SDL_Surface*) const;
+		void Release() noexcept;
+	};
+
+	explicit SDLTextureAtlas(SDL_Renderer*, int pageSize = 2048);
+
+	static bool Fits(int w, int h) noexcept { return w <= CellSize && h <= CellSize; }
+	// returns an empty slot if the sprite doesn't fit or no texture could be created
+	Slot Allocate(int w, int h);
+	// makes the cells released since the last call available again and frees unused pages
+	// must only be called when no pending draw refers to the atlas anymore
+	void Recycle() noexcept;
+
+private:
+	SDL_Renderer* renderer;
+	int pageSize;
+	std::vector<std::shared_ptr<Page>> pages;
+};
+
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include "TableMgr.h"
 #include "GUI/GameControl.h"
 #include "Scriptable/Actor.h"
+#include "Streams/MemoryStream.h"
 
 using namespace GemRB;
 
@@ -115,9 +116,62 @@ bool TLKImporter::Open(DataStream* stream)
 		Log(ERROR, "TLKImporter", "Too many strings ({}), increase OVERRIDE_START.", StrRefCount);
 		return false;
 	}
+
+	// read the index in one go
+	strpos_t indexSize = StrRefCount * 0x1A;
+	void* index = malloc(indexSize);
+	if (str->Read(index, indexSize) != strret_t(indexSize)) {
+		free(index);
+		Log(ERROR, "TLKImporter", "Truncated TLK index.");
+		return false;
+	}
+	MemoryStream indexStream(str->filename, index, indexSize);
+	entries.clear();
+	entries.resize(StrRefCount);
+	for (Entry& entry : entries) {
+		ieDword volume, pitch;
+		indexStream.ReadWord(entry.type);
+		indexStream.ReadResRef(entry.sound);
+		// volume and pitch variance fields are known to be unused at minimum in bg1
+		indexStream.ReadDword(volume);
+		indexStream.ReadDword(pitch);
+		indexStream.ReadDword(entry.offset);
+		indexStream.ReadDword(entry.length);
+	}
+	decodedOrder.clear();
+	decoded.clear();
 	return true;
 }
 
+const TLKImporter::DecodedString& TLKImporter::DecodeString(ieDword strref)
+{
+	auto it = decoded.find(strref);
+	if (it != decoded.end()) {
+		decodedOrder.splice(decodedOrder.begin(), decodedOrder, it->second);
+		return *it->second;
+	}
+
+	if (decodedOrder.size() >= DecodedCacheSize) {
+		decoded.erase(decodedOrder.back().strref);
+		decodedOrder.pop_back();
+	}
+
+	String text;
+	const Entry& entry = entries[strref];
+	if (entry.type & 1 && str->Seek(entry.offset + Offset, GEM_STREAM_START) != GEM_ERROR) {
+		std::string mbstr(entry.length, '\0');
+		str->Read(&mbstr[0], entry.length);
+		String* tmp = StringFromCString(mbstr.c_str());
+		std::swap(text, *tmp);
+		delete tmp;
+	}
+	// the only things ResolveTags changes
+	bool hasTags = text.find_first_of(L"<%[") != String::npos;
+	decodedOrder.push_front({ strref, std::move(text), hasTags });
+	decoded[strref] = decodedOrder.begin();
+	return decodedOrder.front();
+}
+
 /* -1	 - GABBER
 		0	 - PROTAGONIST
 		1-9 - PLAYERx
@@ -338,6 +392,7 @@ String TLKImporter::GetString(ieStrRef strref, STRING_FLAGS flags)
 	bool empty = !(flags & STRING_FLAGS::ALLOW_ZERO) && !strref;
 	ieWord type;
 	ResRef SoundResRef;
+	bool hasTags = true;
 
 	if (empty || strref >= ieStrRef::OVERRIDE_START || (strref >= ieStrRef::BIO_START && strref <= ieStrRef::BIO_END)) {
 		if (OverrideTLK) {
@@ -351,30 +406,19 @@ String TLKImporter::GetString(ieStrRef strref, STRING_FLAGS flags)
 		type = 0;
 		SoundResRef.Reset();
 	} else {
-		ieDword Volume, Pitch, StrOffset;
-		ieDword l;
-		if (str->Seek( 18 + (ieDword(strref) * 0x1A), GEM_STREAM_START ) == GEM_ERROR) {
+		if (ieDword(strref) >= entries.size()) {
 			return L"";
 		}
-		str->ReadWord(type);
-		str->ReadResRef( SoundResRef );
-		// volume and pitch variance fields are known to be unused at minimum in bg1
-		str->ReadDword(Volume);
-		str->ReadDword(Pitch);
-		str->ReadDword(StrOffset);
-		str->ReadDword(l);
-				
-		if (type & 1) {
-			str->Seek( StrOffset + Offset, GEM_STREAM_START );
-			std::string mbstr(l, '\0');
-			str->Read(&mbstr[0], l);
-			String* tmp = StringFromCString(mbstr.c_str());
-			std::swap(string, *tmp);
-			delete tmp;
-		}
+		const Entry& entry = entries[ieDword(strref)];
+		type = entry.type;
+		SoundResRef = entry.sound;
+
+		const DecodedString& decodedString = DecodeString(ieDword(strref));
+		string = decodedString.text;
+		hasTags = decodedString.hasTags;
 	}
 
-	if (bool(flags & STRING_FLAGS::RESOLVE_TAGS) || (type & 4)) {
+	if (hasTags && (bool(flags & STRING_FLAGS::RESOLVE_TAGS) || (type & 4))) {
 		string = ResolveTags(string);
 	}
 	if (type & 2 && bool(flags & STRING_FLAGS::SOUND) && !SoundResRef.IsEmpty()) {
@@ -400,11 +444,10 @@ StringBlock TLKImporter::GetStringBlock(ieStrRef strref, STRING_FLAGS flags)
 	if (empty) {
 		return StringBlock();
 	}
-	ieWord type;
-	str->Seek( 18 + (ieDword(strref) * 0x1A), GEM_STREAM_START );
-	str->ReadWord(type);
 	ResRef soundRef;
-	str->ReadResRef( soundRef );
+	if (ieDword(strref) < entries.size()) {
+		soundRef = entries[ieDword(strref)].sound;
+	}
 	return StringBlock(GetString( strref, flags ), soundRef);
 }
 
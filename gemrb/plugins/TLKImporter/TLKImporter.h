@@ -26,6 +26,10 @@
 #include "Variables.h"
 #include "TlkOverride.h"
 
+#include <list>
+#include <unordered_map>
+#include <vector>
+
 namespace GemRB {
 
 class TLKImporter : public StringMgr {
@@ -40,6 +44,25 @@ private:
 	Variables gtmap;
 	int charname = 0;
 
+	// the whole index is kept in memory, the strings are read on demand
+	struct Entry {
+		ieWord type = 0;
+		ResRef sound;
+		ieDword offset = 0;
+		ieDword length = 0;
+	};
+	std::vector<Entry> entries;
+
+	struct DecodedString {
+		ieDword strref;
+		String text;
+		bool hasTags; // anything for ResolveTags to do
+	};
+	// the most recently used strings, already converted
+	static const size_t DecodedCacheSize = 4096;
+	std::list<DecodedString> decodedOrder;
+	std::unordered_map<ieDword, std::list<DecodedString>::iterator> decoded;
+
 public:
 	TLKImporter(void);
 	~TLKImporter(void) override;
@@ -55,6 +78,7 @@ public:
 	StringBlock GetStringBlock(ieStrRef strref, STRING_FLAGS flags = STRING_FLAGS::NONE) override;
 	bool HasAltTLK() const override;
 private:
+	const DecodedString& DecodeString(ieDword strref);
 	/** resolves day and monthname tokens */
 	void GetMonthName(int dayandmonth);
 	String ResolveTags(const String& source);